@@ -2,6 +2,8 @@
 
 #include "AlgorithmRegistration.h"
 #include "abstract_algorithm.h"
+#include "snapshot_algorithm.h"
+#include "planning_algorithm.h"
 #include "Utils.h"
 
 #include <array>
@@ -17,7 +19,7 @@ using std::stack;
 using std::unordered_map;
 using std::unordered_set;
 
-class AlgoA_206510398_208278945 : public AbstractAlgorithm
+class AlgoA_206510398_208278945 : public AbstractAlgorithm, public SnapshotAlgorithm, public PlanningAlgorithm
 {
 
     struct Point
@@ -56,6 +58,8 @@ class AlgoA_206510398_208278945 : public AbstractAlgorithm
     const BatteryMeter *batteryMeter;
     const DirtSensor *dirtSensor;
     const WallsSensor *wallsSensor;
+    const SensorSnapshot *snapshot; // the readings of the current step, nullptr when the sensors are queried
+    StepPlan *plan;                 // the steps the simulator takes on its own, nullptr when it doesn't
     size_t maxSteps;
     double maxBattery;
     vector<Direction> pathToDock; // caching for shortest path to dock
@@ -78,6 +82,7 @@ private:
     bool isStuck();                                                                   // checking if there is a direction that is not a wall
     void updatePathToDock();                                                          // searching the shortest path from current location to the docking station
     Step returnDocking();                                                             // returning a step on the way to the docking station
+    void planReturn(pair<int, int> from);                                             // the rest of pathToDock from from, over visited positions
     Step exploreStep();                                                               // doing a DFS step
     unordered_map<pair<int, int>, Direction, PairHash, PairEqual> fetchSurrounding(); // returning a set of surrounding coordinates and the step to take to get to that coordinate
     unordered_map<pair<int, int>, Direction, PairHash, PairEqual> fetchSurrounding(pair<int, int> pos);
@@ -89,12 +94,26 @@ private:
     bool isFinish();
     size_t numOfReachable();
 
-    bool isDirty() const { return (dirtSensor->dirtLevel() > 0 && dirtSensor->dirtLevel() <= MAX_DIRT); }
+    // the sensors' readings, from the step's snapshot when the simulator gives one
+    bool readWall(Direction d) const { return snapshot != nullptr ? snapshot->isWall(d) : wallsSensor->isWall(d); }
+    int readDirt() const { return snapshot != nullptr ? snapshot->dirtLevel : dirtSensor->dirtLevel(); }
+    size_t readBattery() const { return snapshot != nullptr ? snapshot->battery : batteryMeter->getBatteryState(); }
+
+    bool isDirty() const { return (readDirt() > 0 && readDirt() <= MAX_DIRT); }
     bool atDocking() const { return position == pair{0, 0}; } // returns true iff robot at the docking station                                                                                      // DELETE - TESTING ONLY
 
 public:
     AlgoA_206510398_208278945();
     virtual Step nextStep() override;
+    virtual Step nextStep(const SensorSnapshot &snapshot) override
+    {
+        this->snapshot = &snapshot;
+        Step step = nextStep();
+        this->snapshot = nullptr;
+        return step;
+    }
+    virtual void setPlan(StepPlan &plan) override { this->plan = &plan; }
+    virtual void planEnded(size_t executed) override;
     virtual void setMaxSteps(size_t maxSteps) override { this->maxSteps = maxSteps; }
     virtual void setWallsSensor(const WallsSensor &wallsSensor) override { this->wallsSensor = &wallsSensor; }
     virtual void setDirtSensor(const DirtSensor &dirtSensor) override { this->dirtSensor = &dirtSensor; }
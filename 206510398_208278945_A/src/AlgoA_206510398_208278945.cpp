@@ -5,7 +5,7 @@ REGISTER_ALGORITHM(AlgoA_206510398_208278945);
 
 // Constructor
 AlgoA_206510398_208278945::AlgoA_206510398_208278945() : totalSteps(0), isExploring(true), lastStep(Step::Stay),
-                             batteryMeter(nullptr), dirtSensor(nullptr), wallsSensor(nullptr),
+                             batteryMeter(nullptr), dirtSensor(nullptr), wallsSensor(nullptr), snapshot(nullptr), plan(nullptr),
                              maxSteps(0), maxBattery(0), pathToDock({}), returningToDock(false), position(pair{0, 0}),
                              dfsNumOfActualVisited(1), dfsBacktracking(false), dfsBackPath({}),
                              dfsMovingNewPos(false), dfsNewPosPath({})
@@ -27,7 +27,7 @@ void AlgoA_206510398_208278945::updateHouseMapping()
     // finding the dirt level of current position
     auto it = houseMapping.find(position);
     auto &pointPtr = it->second;
-    pointPtr->dirtLevel = dirtSensor->dirtLevel();
+    pointPtr->dirtLevel = readDirt();
 
     auto surrounding = fetchSurrounding(); // getting the surrounding in <coordinate, direction to coordinate> format
 
@@ -135,7 +135,7 @@ Step AlgoA_206510398_208278945::nextStep()
 
     Step step;
 
-    if ((batteryMeter->getBatteryState() == 0) && !atDocking())
+    if ((readBattery() == 0) && !atDocking())
     {
         step = Step::Stay;
     }
@@ -146,7 +146,7 @@ Step AlgoA_206510398_208278945::nextStep()
     updatePathToDock(); // need to update the shortest path to the dock
 
     // can only happen in the docking station
-    if (batteryMeter->getBatteryState() == maxBattery)
+    if (readBattery() == maxBattery)
     {
         isExploring = true;
         dfsBacktracking = false;
@@ -170,7 +170,7 @@ Step AlgoA_206510398_208278945::nextStep()
     // We keep exploring and cleaning the house
     else if (isExploring)
     {
-        size_t enoughBattery = batteryMeter->getBatteryState() - pathToDock.size();
+        size_t enoughBattery = readBattery() - pathToDock.size();
         size_t enoughSteps = maxSteps - totalSteps - pathToDock.size();
 
         bool canClean = (enoughBattery >= 1) && (enoughSteps >= 1);       // 1 step to clean
@@ -228,6 +228,12 @@ Step AlgoA_206510398_208278945::nextStep()
                 step = Step::Finish;
             }
         }
+
+        // still charging, the battery is checked again when it's full
+        else if (step == Step::Stay && plan != nullptr)
+        {
+            MyUtils::planCharging(*plan, static_cast<size_t>(maxBattery));
+        }
     }
 
     // Need to go back to docking station
@@ -316,9 +322,43 @@ Step AlgoA_206510398_208278945::returnDocking()
     isExploring = false;
     Direction dir = pathToDock.back();
     pathToDock.pop_back();
+
+    if (plan != nullptr)
+        planReturn(MyUtils::calcNewPosition(dir, position));
+
     return MyUtils::directionToStep(dir);
 }
 
+// the way back only goes on while nothing new can be sensed: from a visited position the mapping already holds its dirt
+// and its surrounding. the plan ends on the first position that wasn't visited, nextStep() maps it and plans again
+void AlgoA_206510398_208278945::planReturn(pair<int, int> from)
+{
+    plan->steps.clear();
+    plan->stopOnDirt = false; // the robot doesn't clean on its way back
+    plan->stopAtBattery = 0;
+
+    for (auto it = pathToDock.rbegin(); it != pathToDock.rend(); ++it)
+    {
+        auto point = houseMapping.find(from);
+        if (point == houseMapping.end() || point->second->dirtLevel == UNDISCOVERED_CODE)
+            break;
+
+        plan->steps.push_back(MyUtils::directionToStep(*it));
+        from = MyUtils::calcNewPosition(*it, from);
+    }
+}
+
+// the planned steps that were taken, as if nextStep() returned them
+void AlgoA_206510398_208278945::planEnded(size_t executed)
+{
+    for (size_t i = 0; i < executed; i++)
+    {
+        position = MyUtils::calcNewPosition(plan->steps[i], position);
+        lastStep = plan->steps[i];
+    }
+    totalSteps += executed;
+}
+
 // doing a DFS step
 Step AlgoA_206510398_208278945::exploreStep()
 {
@@ -474,7 +514,7 @@ unordered_map<pair<int, int>, Direction, AlgoA_206510398_208278945::PairHash, Al
         if (nextPosInHouse != houseMapping.end())
             posReachable = nextPosInHouse->second->reachable;
 
-        if (!(wallsSensor->isWall(dir)) && posReachable)
+        if (!(readWall(dir)) && posReachable)
         {
             surr.insert(pair{nextPos, dir});
         }
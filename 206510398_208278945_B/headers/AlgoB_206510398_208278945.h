@@ -2,6 +2,10 @@
 
 #include "AlgorithmRegistration.h"
 #include "abstract_algorithm.h"
+#include "snapshot_algorithm.h"
+#include "planning_algorithm.h"
+#include "seeded_algorithm.h"
+#include "configurable_algorithm.h"
 #include "battery_meter.h"
 #include "dirt_sensor.h"
 #include "wall_sensor.h"
@@ -26,7 +30,7 @@ using std::unordered_set;
 
 #define CONFIG_NAME "AlgoB_206510398_208278945.config"
 
-class AlgoB_206510398_208278945 : public AbstractAlgorithm
+class AlgoB_206510398_208278945 : public AbstractAlgorithm, public SeededAlgorithm, public ConfigurableAlgorithm, public SnapshotAlgorithm, public PlanningAlgorithm
 {
 
     struct Point
@@ -66,6 +70,8 @@ class AlgoB_206510398_208278945 : public AbstractAlgorithm
     const BatteryMeter *batteryMeter;
     const DirtSensor *dirtSensor;
     const WallsSensor *wallsSensor;
+    const SensorSnapshot *snapshot; // the readings of the current step, nullptr when the sensors are queried
+    StepPlan *plan;                 // the steps the simulator takes on its own, nullptr when it doesn't
     size_t maxSteps;
     double maxBattery;
     vector<Direction> pathToDock; // caching for shortest path to dock
@@ -82,10 +88,11 @@ class AlgoB_206510398_208278945 : public AbstractAlgorithm
     bool dfsMovingNewPos;                                          // flag to know if we are on the way to a new position after the stack emptied
     vector<Direction> dfsNewPosPath;                               // holds the path to new position
     Direction nextSpiralDir;
-    std::random_device rd;                                          // seed
+    std::random_device rd;                                          // seed, unless the simulator sets one
     std::mt19937 gen;                                               // random engine
 
     bool spiralClockwise;
+    bool configLoaded; // by setConfig(), or from the config file alone by setMaxSteps(), before the first step
 
 private:
     void updateHouseMapping();                                                        // adding mapping of surrounding points of position
@@ -93,6 +100,7 @@ private:
     bool isStuck();                                                                   // checking if there is a direction that is not a wall
     void updatePathToDock();                                                          // searching the shortest path from current location to the docking station
     Step returnDocking();                                                             // returning a step on the way to the docking station
+    void planReturn(pair<int, int> from);                                             // the rest of pathToDock from from, over visited positions
     Step exploreStep();                                                               // doing a DFS step
     unordered_map<pair<int, int>, Direction, PairHash, PairEqual> fetchSurrounding(); // returning a set of surrounding coordinates and the step to take to get to that coordinate
     unordered_map<pair<int, int>, Direction, PairHash, PairEqual> fetchSurrounding(pair<int, int> pos);
@@ -101,19 +109,38 @@ private:
     bool isFinish();
     size_t numOfReachable();
 
-    bool isDirty() const { return (dirtSensor->dirtLevel() > 0 && dirtSensor->dirtLevel() <= MAX_DIRT); }
+    // the sensors' readings, from the step's snapshot when the simulator gives one
+    bool readWall(Direction d) const { return snapshot != nullptr ? snapshot->isWall(d) : wallsSensor->isWall(d); }
+    int readDirt() const { return snapshot != nullptr ? snapshot->dirtLevel : dirtSensor->dirtLevel(); }
+    size_t readBattery() const { return snapshot != nullptr ? snapshot->battery : batteryMeter->getBatteryState(); }
+
+    bool isDirty() const { return (readDirt() > 0 && readDirt() <= MAX_DIRT); }
     bool atDocking() const { return position == pair{0, 0}; } // returns true iff robot at the docking station
     pair<int, int> computeOptimalNextPos();
     size_t computeDistance(pair<int,int> dst);
     size_t decideUniformIndex(size_t range);
     Step popNewPathStep();
     Step fetchSpiralDir();
-    void loadConfigs();
+    void loadConfigs(const MyUtils::ConfigValues *overrides = nullptr); // throws std::invalid_argument on a bad config
     
 public:
     AlgoB_206510398_208278945();
     virtual Step nextStep() override;
-    virtual void setMaxSteps(size_t maxSteps) override { this->maxSteps = maxSteps; }
+    virtual Step nextStep(const SensorSnapshot &snapshot) override
+    {
+        this->snapshot = &snapshot;
+        Step step = nextStep();
+        this->snapshot = nullptr;
+        return step;
+    }
+    virtual void setPlan(StepPlan &plan) override { this->plan = &plan; }
+    virtual void planEnded(size_t executed) override;
+    virtual void setMaxSteps(size_t maxSteps) override
+    {
+        this->maxSteps = maxSteps;
+        if (!configLoaded)
+            loadConfigs();
+    }
     virtual void setWallsSensor(const WallsSensor &wallsSensor) override { this->wallsSensor = &wallsSensor; }
     virtual void setDirtSensor(const DirtSensor &dirtSensor) override { this->dirtSensor = &dirtSensor; }
     virtual void setBatteryMeter(const BatteryMeter &batteryMeter) override
@@ -121,4 +148,11 @@ public:
         this->batteryMeter = &batteryMeter;
         maxBattery = this->batteryMeter->getBatteryState();
     }
+    virtual void setSeed(std::uint64_t seed) override
+    {
+        std::seed_seq seq{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+        gen.seed(seq);
+    }
+    virtual void setConfig(const std::map<string, string> &values) override { loadConfigs(&values); }
+    virtual vector<string> configNames() const override { return {"spiralClockwise"}; }
 };
\ No newline at end of file
@@ -5,12 +5,12 @@ REGISTER_ALGORITHM(AlgoB_206510398_208278945);
 // Constructor
 AlgoB_206510398_208278945::AlgoB_206510398_208278945() 
 :   totalSteps(0), isExploring(true), lastStep(Step::Stay),
-    batteryMeter(nullptr), dirtSensor(nullptr), wallsSensor(nullptr),
+    batteryMeter(nullptr), dirtSensor(nullptr), wallsSensor(nullptr), snapshot(nullptr), plan(nullptr),
     maxSteps(0), maxBattery(0), pathToDock({}), 
     returningToDock(false), position(pair{0, 0}),
     dfsNumOfActualVisited(1), dfsBackPath({}),
     dfsMovingNewPos(false), dfsNewPosPath({}), 
-    nextSpiralDir(Direction::North) ,gen(rd())
+    nextSpiralDir(Direction::North) ,gen(rd()), spiralClockwise(false), configLoaded(false)
 {
     // Initialize an empty stack
     dfsStack.push(pair{0, 0});
@@ -21,9 +21,13 @@ AlgoB_206510398_208278945::AlgoB_206510398_208278945()
 
     // Intializing the house mapping to hold the docking station
     houseMapping.insert(pair{pair{0, 0}, std::make_unique<Point>(pair{0, 0})});
+}
 
+void AlgoB_206510398_208278945::loadConfigs(const MyUtils::ConfigValues *overrides)
+{
     vector<pair<string, bool*>> pairs = {{"spiralClockwise", &spiralClockwise}};
-    MyUtils::loadConfig(CONFIG_NAME, pairs);
+    MyUtils::loadConfig(CONFIG_NAME, pairs, overrides);
+    configLoaded = true;
 }
 
 
@@ -33,7 +37,7 @@ void AlgoB_206510398_208278945::updateHouseMapping()
     // finding the dirt level of current position
     auto it = houseMapping.find(position);
     auto &pointPtr = it->second;
-    pointPtr->dirtLevel = dirtSensor->dirtLevel();
+    pointPtr->dirtLevel = readDirt();
 
     auto surrounding = fetchSurrounding(); // getting the surrounding in <coordinate, direction to coordinate> format
 
@@ -120,10 +124,9 @@ void AlgoB_206510398_208278945::insertCoordinate(pair<int, int> pos)
 
 Step AlgoB_206510398_208278945::nextStep()
 {
-
     Step step;
 
-    if ((batteryMeter->getBatteryState() == 0) && !atDocking())
+    if ((readBattery() == 0) && !atDocking())
     {
         step = Step::Stay;
     }
@@ -133,7 +136,7 @@ Step AlgoB_206510398_208278945::nextStep()
     updatePathToDock(); // need to update the shortest path to the dock
 
     // can only happen in the docking station
-    if (batteryMeter->getBatteryState() == maxBattery)
+    if (readBattery() == maxBattery)
     {
         isExploring = true;
         dfsMovingNewPos = false;
@@ -156,7 +159,7 @@ Step AlgoB_206510398_208278945::nextStep()
     // We keep exploring and cleaning the house
     else if (isExploring)
     {
-        size_t enoughBattery = batteryMeter->getBatteryState() - pathToDock.size();
+        size_t enoughBattery = readBattery() - pathToDock.size();
         size_t enoughSteps = maxSteps - totalSteps - pathToDock.size();
 
         bool canClean = (enoughBattery >= 1) && (enoughSteps >= 1);       // 1 step to clean
@@ -214,6 +217,12 @@ Step AlgoB_206510398_208278945::nextStep()
                 step = Step::Finish;
             }
         }
+
+        // still charging, the battery is checked again when it's full
+        else if (step == Step::Stay && plan != nullptr)
+        {
+            MyUtils::planCharging(*plan, static_cast<size_t>(maxBattery));
+        }
     }
 
     // Need to go back to docking station
@@ -302,9 +311,43 @@ Step AlgoB_206510398_208278945::returnDocking()
     isExploring = false;
     Direction dir = pathToDock.back();
     pathToDock.pop_back();
+
+    if (plan != nullptr)
+        planReturn(MyUtils::calcNewPosition(dir, position));
+
     return MyUtils::directionToStep(dir);
 }
 
+// the way back only goes on while nothing new can be sensed: from a visited position the mapping already holds its dirt
+// and its surrounding. the plan ends on the first position that wasn't visited, nextStep() maps it and plans again
+void AlgoB_206510398_208278945::planReturn(pair<int, int> from)
+{
+    plan->steps.clear();
+    plan->stopOnDirt = false; // the robot doesn't clean on its way back
+    plan->stopAtBattery = 0;
+
+    for (auto it = pathToDock.rbegin(); it != pathToDock.rend(); ++it)
+    {
+        auto point = houseMapping.find(from);
+        if (point == houseMapping.end() || point->second->dirtLevel == UNDISCOVERED_CODE)
+            break;
+
+        plan->steps.push_back(MyUtils::directionToStep(*it));
+        from = MyUtils::calcNewPosition(*it, from);
+    }
+}
+
+// the planned steps that were taken, as if nextStep() returned them
+void AlgoB_206510398_208278945::planEnded(size_t executed)
+{
+    for (size_t i = 0; i < executed; i++)
+    {
+        position = MyUtils::calcNewPosition(plan->steps[i], position);
+        lastStep = plan->steps[i];
+    }
+    totalSteps += executed;
+}
+
 pair<int, int> AlgoB_206510398_208278945::computeOptimalNextPos()
 {
     // Collect unvisited positions from 'circlesLeft' circles,
@@ -377,7 +420,7 @@ pair<int, int> AlgoB_206510398_208278945::computeOptimalNextPos()
         }
     }
 
-    if (optimalPositions.empty()) //|| optimalObjective >= batteryMeter->getBatteryState())
+    if (optimalPositions.empty()) //|| optimalObjective >= readBattery())
         return dockPos;
     size_t randIdx = decideUniformIndex(optimalPositions.size());
     return optimalPositions[randIdx];
@@ -414,7 +457,7 @@ Step AlgoB_206510398_208278945::exploreStep()
     if (dfsNumOfActualVisited < reachableSize)
     {
         pair<int, int> nextPos = MyUtils::calcNewPosition(nextSpiralDir, position);
-        bool isSpiralDirValid = !(wallsSensor->isWall(nextSpiralDir)) && visited.find(nextPos) == visited.end();
+        bool isSpiralDirValid = !(readWall(nextSpiralDir)) && visited.find(nextPos) == visited.end();
         
         Direction straight;
         if(spiralClockwise)
@@ -423,7 +466,7 @@ Step AlgoB_206510398_208278945::exploreStep()
             straight = static_cast<Direction>((static_cast<int>(nextSpiralDir) + 1) % 4);
         
         nextPos = MyUtils::calcNewPosition(straight, position);
-        bool isStraightDirValid = !(wallsSensor->isWall(straight)) && visited.find(nextPos) == visited.end();
+        bool isStraightDirValid = !(readWall(straight)) && visited.find(nextPos) == visited.end();
         if(!isStraightDirValid && !isSpiralDirValid)
         {
             pair<int, int> targetPos = computeOptimalNextPos();
@@ -502,9 +545,9 @@ unordered_map<pair<int, int>, Direction, AlgoB_206510398_208278945::PairHash, Al
         if (nextPosInHouse != houseMapping.end())
         {
             posReachable = nextPosInHouse->second->reachable;
-            nextPosInHouse->second->isWall = wallsSensor->isWall(dir);
+            nextPosInHouse->second->isWall = readWall(dir);
         }
-        if (!(wallsSensor->isWall(dir)) && posReachable)
+        if (!(readWall(dir)) && posReachable)
         {
             surr.insert(pair{nextPos, dir});
         }
@@ -0,0 +1,139 @@
+#include "Simulator.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#define SHORT_RUN_STEPS 1000
+#define LONG_RUN_STEPS 100000
+
+// every allocation of the process is counted while counting is set
+static std::atomic<size_t> numAllocs(0);
+static std::atomic<bool> counting(false);
+
+void *operator new(size_t size)
+{
+    if (counting.load(std::memory_order_relaxed))
+        numAllocs.fetch_add(1, std::memory_order_relaxed);
+
+    void *p = std::malloc(size != 0 ? size : 1);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    std::free(p);
+}
+
+// goes back and forth along the docking station's row, it allocates nothing itself
+class BounceAlgorithm : public AbstractAlgorithm
+{
+    const WallsSensor *wallsSensor = nullptr;
+    Direction dir = Direction::East;
+
+public:
+    virtual void setMaxSteps(size_t) override {}
+    virtual void setWallsSensor(const WallsSensor &sensor) override { wallsSensor = &sensor; }
+    virtual void setDirtSensor(const DirtSensor &) override {}
+    virtual void setBatteryMeter(const BatteryMeter &) override {}
+
+    virtual Step nextStep() override
+    {
+        if (wallsSensor->isWall(dir))
+            dir = dir == Direction::East ? Direction::West : Direction::East;
+        if (wallsSensor->isWall(dir))
+            return Step::Stay;
+        return static_cast<Step>(dir);
+    }
+};
+
+// a copy of the house that runs for maxSteps steps, with a battery that outlasts them
+fs::path writeHouse(const fs::path &housePath, size_t maxSteps)
+{
+    std::ifstream in(housePath);
+    fs::path copyPath = fs::temp_directory_path() / ("alloc_test_" + std::to_string(maxSteps) + ".house");
+    std::ofstream out(copyPath);
+
+    string line;
+    while (std::getline(in, line))
+    {
+        if (line.rfind("MaxSteps", 0) == 0)
+            line = "MaxSteps = " + std::to_string(maxSteps);
+        else if (line.rfind("MaxBattery", 0) == 0)
+            line = "MaxBattery = " + std::to_string(2 * maxSteps);
+        out << line << '\n';
+    }
+
+    return copyPath;
+}
+
+// the allocations of one run(), and its steps
+pair<size_t, size_t> countRunAllocs(const fs::path &housePath, bool writeLog)
+{
+    MyHouse house(housePath);
+    ConfigValues config = {{"timeoutCoefficient", "1000"}};
+    MySimulator sim("BounceAlgorithm", false, writeLog, &config);
+    BounceAlgorithm algo;
+    sim.setHouse(house);
+    sim.setAlgorithm(algo);
+
+    numAllocs = 0;
+    counting = true;
+    sim.run();
+    counting = false;
+
+    return {numAllocs.load(), sim.getNumSteps()};
+}
+
+// checks that the simulator's step loop allocates nothing: a run 100 times longer may not allocate more,
+// what run() allocates once (the timeout timer) is the same for both
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <house file>" << endl;
+        return 2;
+    }
+
+    try
+    {
+        fs::path shortHouse = writeHouse(argv[1], SHORT_RUN_STEPS);
+        fs::path longHouse = writeHouse(argv[1], LONG_RUN_STEPS);
+
+        bool failed = false;
+        for (bool writeLog : {false, true})
+        {
+            auto [shortAllocs, shortSteps] = countRunAllocs(shortHouse, writeLog);
+            auto [longAllocs, longSteps] = countRunAllocs(longHouse, writeLog);
+
+            std::cout << "log=" << writeLog << ": " << shortSteps << " steps " << shortAllocs << " allocations, "
+                      << longSteps << " steps " << longAllocs << " allocations" << endl;
+
+            if (longSteps != LONG_RUN_STEPS || longAllocs != shortAllocs)
+                failed = true;
+        }
+
+        fs::remove(shortHouse);
+        fs::remove(longHouse);
+
+        if (failed)
+        {
+            std::cerr << "the step loop allocates" << endl;
+            return 1;
+        }
+    }
+    catch (const CustomError &e)
+    {
+        std::cerr << e.content << endl;
+        return 2;
+    }
+
+    return 0;
+}
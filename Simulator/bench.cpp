@@ -0,0 +1,201 @@
+#include "AlgorithmRegistrar.h"
+#include "Batch.h"
+
+#include <cmath>
+#include <dlfcn.h>
+#include <iomanip>
+#include <sys/resource.h>
+#include <thread>
+
+#define BENCH_FILE_NAME "scaling.csv"
+
+// the spread of the measurements of one thread count
+struct RunStats
+{
+    double median = 0;
+    double min = 0;
+    double stddev = 0;
+};
+
+RunStats computeRunStats(vector<double> values)
+{
+    RunStats stats;
+    if (values.empty())
+        return stats;
+
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    stats.median = values.size() % 2 == 1 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+    stats.min = values.front();
+
+    double sum = 0;
+    for (double value : values)
+        sum += value;
+    double mean = sum / static_cast<double>(values.size());
+
+    double squares = 0;
+    for (double value : values)
+        squares += (value - mean) * (value - mean);
+    if (values.size() > 1)
+        stats.stddev = std::sqrt(squares / static_cast<double>(values.size() - 1));
+
+    return stats;
+}
+
+// the user and system time of every thread of the process so far, in ms
+double processCpuMs()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    auto ms = [](const timeval &tv)
+    {
+        return static_cast<double>(tv.tv_sec) * 1e3 + static_cast<double>(tv.tv_usec) / 1e3;
+    };
+    return ms(usage.ru_utime) + ms(usage.ru_stime);
+}
+
+// 1, 2, 4 ... up to maxThreads, and maxThreads itself
+vector<size_t> threadCounts(size_t maxThreads)
+{
+    vector<size_t> counts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+// Measures how myrobot scales with its number of threads.
+// The corpus (every algorithm on every house, copied -copies times) is run in-process at -num_thread = 1, 2, 4 ... max,
+// -runs times per count after a warm-up run. The houses are parsed once and nothing is written but the report,
+// so the runs measure the dispatcher and the simulations. The stochastic algorithms get a fixed seed.
+// usage: myrobot_bench [-house_path=<dir>] [-algo_path=<dir>] [-max_threads=<n>] [-runs=<n>] [-copies=<n>] [-output=<file>]
+int main(int argc, char **argv)
+{
+    string housePath = "./";
+    string algoPath = "./";
+    size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    size_t runs = 5;
+    size_t copies = 1;
+    string outputName = BENCH_FILE_NAME;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        size_t pos = arg.find('=');
+        if (pos == string::npos)
+            continue;
+
+        string key = arg.substr(0, pos);
+        string value = arg.substr(pos + 1);
+
+        if (key.compare("-house_path") == 0)
+            housePath = value;
+        if (key.compare("-algo_path") == 0)
+            algoPath = value;
+        if (key.compare("-max_threads") == 0 && std::stoul(value) > 0)
+            maxThreads = std::stoul(value);
+        if (key.compare("-runs") == 0 && std::stoul(value) > 0)
+            runs = std::stoul(value);
+        if (key.compare("-copies") == 0 && std::stoul(value) > 0)
+            copies = std::stoul(value);
+        if (key.compare("-output") == 0)
+            outputName = value;
+    }
+
+    vector<void *> libsHandle;
+    vector<shared_ptr<const MyHouse>> houses;
+    std::error_code ec;
+    try
+    {
+        for (const auto &entry : fs::directory_iterator(algoPath, ec))
+        {
+            if (!entry.is_regular_file() || entry.path().extension() != ".so")
+                continue;
+
+            void *handle = dlopen(entry.path().c_str(), RTLD_GLOBAL | RTLD_NOW);
+            if (handle == nullptr)
+                std::cerr << "Error: Failed loading " << entry.path().string() << " - " << dlerror() << std::endl;
+            else
+                libsHandle.push_back(handle);
+        }
+
+        for (const auto &entry : fs::directory_iterator(housePath, ec))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".house")
+                houses.push_back(std::make_shared<const MyHouse>(entry.path()));
+        }
+    }
+    catch (const CustomError &e)
+    {
+        std::cerr << e.content << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+    if (registrar.count() == 0 || houses.empty())
+    {
+        std::cerr << "Error: No algorithms or no houses to run" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream report(outputName);
+    if (!report.is_open())
+    {
+        std::cerr << "Error: Failed to open output file (" << outputName << ")" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    report << "Threads,Runs,Tasks,WallMedianMs,WallMinMs,WallStddevMs,CpuMedianMs,TasksPerSec,Speedup,Efficiency\n";
+    report << std::fixed << std::setprecision(3);
+
+    double baseWallMs = 0;
+    for (size_t threads : threadCounts(maxThreads))
+    {
+        BatchOptions options;
+        options.numThreads = threads;
+        options.seed = 0;
+
+        vector<double> wallMs, cpuMs;
+        size_t tasks = 0;
+        for (size_t run = 0; run <= runs; run++)
+        {
+            MySimulatorBatch batch(options);
+            batch.addAlgorithms(registrar);
+            for (size_t copy = 0; copy < copies; copy++)
+            {
+                for (const auto &house : houses)
+                    batch.addHouse(house);
+            }
+
+            double cpuStart = processCpuMs();
+            auto wallStart = std::chrono::steady_clock::now();
+            tasks = batch.run().size();
+            auto wallEnd = std::chrono::steady_clock::now();
+            double cpuEnd = processCpuMs();
+
+            // the first run only warms up the caches and the allocator
+            if (run == 0)
+                continue;
+
+            wallMs.push_back(std::chrono::duration<double, std::milli>(wallEnd - wallStart).count());
+            cpuMs.push_back(cpuEnd - cpuStart);
+        }
+
+        RunStats wall = computeRunStats(wallMs);
+        RunStats cpu = computeRunStats(cpuMs);
+        if (threads == 1)
+            baseWallMs = wall.median;
+
+        double speedup = wall.median > 0 ? baseWallMs / wall.median : 0;
+        report << threads << "," << runs << "," << tasks << "," << wall.median << "," << wall.min << "," << wall.stddev << ","
+               << cpu.median << "," << (wall.median > 0 ? static_cast<double>(tasks) * 1e3 / wall.median : 0) << ","
+               << speedup << "," << speedup / static_cast<double>(threads) << "\n";
+        report.flush();
+    }
+
+    AlgorithmRegistrar::getAlgorithmRegistrar().clear();
+    for (auto handle : libsHandle)
+        dlclose(handle);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "AlgorithmRegistrar.h"
+#include "ErrorLog.h"
+#include "House.h"
+#include "Journal.h"
+#include "Placement.h"
+#include "ResultCache.h"
+#include "Results.h"
+#include "Scheduler.h"
+
+#include <functional>
+#include <optional>
+
+using std::function;
+using MyUtils::ConfigValues;
+
+// How a batch runs. Nothing is written to disk unless asked
+struct BatchOptions
+{
+    size_t numThreads = 10;
+    bool writeOutput = false; // the <house>-<algorithm>.txt output files
+    bool writeLog = false;    // the <house>-<algorithm>.log files
+    bool writeErrors = false; // the .error files, the errors are in the results either way
+    size_t memoryBudget = 0;  // bytes, 0 for no limit
+    MyPlacement placement;
+    bool isolate = false;                   // run the cells in worker processes, see MyProcessPool
+    string statsPath = "";                  // the live progress file, see MyRunProgress
+    string tracePath = "";                  // the timeline of the run, see MyRunTrace
+    MyTimingHistory *history = nullptr;     // orders the cells and records their runtimes
+    MyResultJournal *journal = nullptr;     // every finished cell is appended to it
+    MyResultCache *cache = nullptr;         // only used for the houses given by path
+    function<bool(size_t algoIndex, size_t houseIndex)> filter; // the cells to run, all of them if empty
+    size_t repeats = 1;           // samples of every cell of a seeded algorithm (see SeededAlgorithm), the others run once
+    std::optional<uint64_t> seed; // sample r gets seed + r. drawn at random when repeating without one
+    vector<ConfigValues> configs; // a parameter sweep: every cell runs with each of them, instead of the config files
+};
+
+// The outcome of one (algorithm, house) cell of a batch
+struct BatchResult
+{
+    size_t algoIndex = 0;
+    size_t houseIndex = 0;
+    size_t config = 0; // the index in BatchOptions::configs
+    size_t sample = 0;
+    bool seeded = false; // the algorithm was given seed
+    uint64_t seed = 0;
+    CellResult result;
+    string errorOwner; // the .error file the error belongs to (house, algorithm, "Simulator" or "General"), empty if none
+    string error;
+};
+
+// Runs every algorithm on every house, in-process, on an internal pool of workers.
+// Houses are given parsed, or by path and parsed once by the first cell that runs on them.
+// myrobot is a wrapper around it that adds the discovery, the library loading and the summary files.
+class MySimulatorBatch
+{
+    struct Algorithm
+    {
+        string name;
+        AlgorithmFactory factory;
+        fs::path library; // for the cache key, empty if unknown
+    };
+
+    struct House
+    {
+        string name;
+        shared_ptr<const MyHouse> parsed; // set for the houses given parsed
+        fs::path path;                    // the house's file, empty if a house given parsed didn't say
+        HouseHeader header;
+    };
+
+    BatchOptions options;
+    vector<Algorithm> algorithms;
+    vector<House> houses;
+
+public:
+    // Constructor
+    MySimulatorBatch(BatchOptions options = BatchOptions()) : options(std::move(options)) {}
+
+    // the factory has to stay valid until run() returns. returns the algorithm's index
+    size_t addAlgorithm(string name, AlgorithmFactory factory, fs::path library = {});
+
+    // every algorithm in the registrar, in registration order
+    void addAlgorithms(const AlgorithmRegistrar &registrar);
+
+    // a house that was already parsed, from path if it's known (the cache needs it). returns the house's index
+    size_t addHouse(shared_ptr<const MyHouse> house, fs::path path = {});
+
+    // a .house file, parsed on first use. returns the house's index
+    size_t addHouse(const fs::path &path);
+
+    vector<string> getAlgoNames() const;
+    vector<string> getHouseNames() const;
+
+    // runs the cells and blocks until all of them are done, may be called again.
+    // returns a result for every config and sample of every cell that ran, by algorithm, house, config and sample.
+    // only the first config and sample of a cell write its output and log files, the others aren't cached
+    // in an isolated run the errors a worker process hit are only in the .error files, with writeErrors
+    vector<BatchResult> run();
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+using std::string;
+
+enum class ErrOwnership
+{
+	House,
+	Algorithm,
+	Simulator
+};
+
+
+struct CustomError
+{
+	ErrOwnership owner;
+	string content;
+	size_t score;
+	CustomError(ErrOwnership owner, string content, size_t score = 0): owner(owner), content(content), score(score) {}
+};
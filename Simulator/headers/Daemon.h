@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Batch.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#define DAEMON_SOCKET_NAME "myrobot.sock"
+#define DAEMON_SCAN_INTERVAL_MS 1000
+
+// Resident mode of myrobot (-daemon).
+// The houses are parsed once and kept in memory. The algorithm directory is rescanned every DAEMON_SCAN_INTERVAL_MS,
+// a new or changed .so is loaded (again) once it was left untouched for a whole interval, and only its algorithms
+// are run on every house. A removed .so takes its algorithms out of the results. summary.csv is rewritten after every run.
+// Clients connect to a Unix domain socket and send one command per connection:
+//   summary                      the current summary.csv
+//   result <algorithm> <house>   the cell in the journal's form, "none" if it wasn't run
+//   status                       the number of algorithms, houses and runs so far
+//   quit                         stops the daemon
+class MyDaemon
+{
+    // a loaded .so and the algorithms it registered
+    struct Library
+    {
+        fs::file_time_type mtime;
+        uintmax_t size = 0;
+        void *handle = nullptr;
+        vector<string> algoNames;
+        vector<AlgorithmFactory> algoFactories; // copies of the registrar entries, released before dlclose
+    };
+
+    BatchOptions options; // the options of every run
+    fs::path housePath;
+    fs::path algoPath;
+    string socketPath;
+    string csvFileName;
+    string historyPath; // options.history is saved there after every run
+    bool detailedSummary;
+
+    vector<string> houseNames;
+    vector<shared_ptr<const MyHouse>> houses; // nullptr for a house that failed to parse, it runs by path
+    vector<fs::path> houseFiles;
+    std::map<fs::path, Library> libraries;
+
+    std::mutex mtx;                                  // protects results and runs, read by the socket thread
+    std::map<string, vector<CellResult>> results;   // a row per algorithm, by house index
+    size_t runs;
+
+    int listenFd;
+    std::thread server;
+    std::atomic<bool> stopping;
+
+private:
+    void loadHouses();
+
+    // the libraries that were added or changed (and then left untouched), and the ones removed
+    void scanLibraries(vector<fs::path> &changed, vector<fs::path> &removed);
+
+    void unloadLibrary(const fs::path &path);
+    void loadLibrary(const fs::path &path);
+    void runLibraries(const vector<fs::path> &paths);
+    MyResultMatrix currentResults();
+    void writeSummary();
+
+    bool startServer();
+    void serverLoop();
+    string handleCommand(const string &line);
+
+public:
+    // Constructor - options are used by every run, the daemon adds the algorithms and houses itself
+    MyDaemon(BatchOptions options, fs::path housePath, fs::path algoPath, string socketPath, string csvFileName,
+             string historyPath, bool detailedSummary);
+
+    // Deconstructor - stops the socket server and closes the libraries
+    ~MyDaemon();
+
+    MyDaemon(const MyDaemon &) = delete;
+    MyDaemon &operator=(const MyDaemon &) = delete;
+
+    // serves until a client sends "quit" or the process gets SIGINT or SIGTERM. returns the exit code
+    int run();
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+#define ERROR_DIR_PATH "./errors/"
+#define ERROR_FLUSH_BATCH 64
+
+// The .error files of the process.
+// Workers only push their errors onto a lock-free list. A flush groups the pending errors by file and writes
+// every file once, at the end of a batch or whenever ERROR_FLUSH_BATCH errors are pending and no one else is flushing.
+// A file holds every distinct error reported to it by the process, the first flush to it truncates what an earlier
+// process left there. A process that forks workers claims their files first, so the workers and it only append.
+// A flush doesn't start threads, so the process pool can still fork.
+class MyErrorLog
+{
+    struct Entry
+    {
+        string filename;
+        string content;
+        Entry *next;
+    };
+
+    std::atomic<Entry *> pending;
+    std::atomic<size_t> numPending;
+
+    std::mutex flushMtx;                         // one flush at a time
+    std::map<string, vector<string>> written;    // the errors already in every file, under flushMtx
+    std::set<string> opened;                     // the files this process (or the one that forked it) started, under flushMtx
+
+private:
+    MyErrorLog() : pending(nullptr), numPending(0) {}
+
+    // pre: flushMtx is held
+    void writePending();
+
+public:
+    // Deconstructor - writes what is still pending
+    ~MyErrorLog();
+
+    MyErrorLog(const MyErrorLog &) = delete;
+    MyErrorLog &operator=(const MyErrorLog &) = delete;
+
+    static MyErrorLog &getErrorLog();
+
+    // never blocks on a flush in progress
+    void add(const string &filename, const string &content);
+
+    // writes the pending errors, after waiting for a flush in progress
+    void flush();
+
+    // removes what an earlier process left in the files, unless this process already wrote to them.
+    // called before forking, the forked processes then append to the files like this one
+    void claim(const vector<string> &filenames);
+};
+
+// queues an error for ./errors/<filename>.error
+void writeErrFile(const string &filename, const string &content);
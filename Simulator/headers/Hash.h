@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+// 64-bit FNV-1a. Stable across runs, machines and builds, unlike std::hash
+inline uint64_t fnv1a(const char *data, size_t size, uint64_t hash = FNV_OFFSET_BASIS)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+inline uint64_t fnv1a(const std::string &str, uint64_t hash = FNV_OFFSET_BASIS)
+{
+    return fnv1a(str.data(), str.size(), hash);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CustomError.h"
+#include "HouseGrid.h"
+#include "Utils.h"
+
+#include <atomic>
+#include <mutex>
+
+// The numeric fields at the top of a .house file
+struct HouseHeader
+{
+    size_t maxSteps = 0;
+    size_t maxBattery = 0;
+    size_t rows = 0;
+    size_t cols = 0;
+};
+
+// reads only the header lines of a house file, the structure itself is skipped
+// returns false if the file can't be opened
+bool readHouseHeader(const fs::path &housePath, HouseHeader &header);
+
+// A parsed .house file. Built once and shared read-only by every simulation on that house,
+// each simulation copies the structure before cleaning it. The walls never change, the wall mask isn't copied.
+class MyHouse
+{
+    string name;                           // file name without the .house suffix
+    string description;
+    size_t maxSteps;
+    double maxBattery;
+    size_t rows;                           // padded dimensions
+    size_t cols;                           // padded dimensions
+    MyHouseGrid structure;                 // padded with walls on every side
+    MyHouseGrid wallMask;                  // the walls around every cell of structure, see MyHouseGrid::wallMask
+    pair<size_t, size_t> dockingLocation;  // (y,x) in the padded structure
+    size_t totalDirt;
+
+private:
+    void wallPadding();
+    void sumDirt();
+
+public:
+    // Constructor - parses the file, throws CustomError on an invalid house
+    MyHouse(const fs::path &filename);
+
+    const string &getName() const { return name; }
+    const string &getDescription() const { return description; }
+    size_t getMaxSteps() const { return maxSteps; }
+    double getMaxBattery() const { return maxBattery; }
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    const MyHouseGrid &getStructure() const { return structure; }
+    const MyHouseGrid &getWallMask() const { return wallMask; }
+    const pair<size_t, size_t> &getDockingLocation() const { return dockingLocation; }
+    size_t getTotalDirt() const { return totalDirt; }
+};
+
+// Parses a house on first use and hands the same parsed house to every task on it.
+// The house is released once the last task that uses it is done.
+class MyHouseLoader
+{
+    fs::path path;
+    std::once_flag once;
+    shared_ptr<const MyHouse> house;
+    unique_ptr<CustomError> error; // the parse error, reported to every task on the house
+    std::atomic<size_t> usesLeft;
+
+public:
+    // Constructor
+    MyHouseLoader(fs::path path, size_t uses) : path(std::move(path)), usesLeft(uses) {}
+
+    // Constructor - for a house that was already parsed
+    MyHouseLoader(shared_ptr<const MyHouse> parsed, size_t uses);
+
+    // parses the house on the first call. throws the parse error on every call
+    shared_ptr<const MyHouse> get();
+
+    // a task on the house is done with it
+    void release();
+
+    const fs::path &getPath() const { return path; }
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Utils.h"
+
+#include <cstdint>
+
+// a cell of a wall mask: bit d is set if the neighbor in Direction d is a wall or off the grid,
+// WALL_MASK_SELF if the cell itself is a wall
+#define WALL_MASK_NEIGHBORS 0x0F
+#define WALL_MASK_SELF 0x10
+
+inline uint8_t wallBit(Direction d)
+{
+    return static_cast<uint8_t>(1 << static_cast<int>(d));
+}
+
+// A house structure, a byte per cell (every code fits, up to UNDISCOVERED_CODE), stored row after row.
+// One allocation for the whole house, a cell's neighbors are a stride away.
+class MyHouseGrid
+{
+    size_t rows;
+    size_t cols; // the stride of a row
+    vector<uint8_t> cells;
+
+public:
+    // Constructor
+    MyHouseGrid() : rows(0), cols(0) {}
+
+    // Constructor - every cell holds fill
+    MyHouseGrid(size_t rows, size_t cols, uint8_t fill = CLEAN_CODE) : rows(rows), cols(cols), cells(rows * cols, fill) {}
+
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+
+    bool contains(size_t row, size_t col) const { return row < rows && col < cols; }
+
+    // pre: contains(row, col)
+    uint8_t &at(size_t row, size_t col) { return cells[row * cols + col]; }
+    uint8_t at(size_t row, size_t col) const { return cells[row * cols + col]; }
+
+    const vector<uint8_t> &getCells() const { return cells; }
+
+    // the wall mask of every cell. the walls never change during a simulation, only the dirt does
+    MyHouseGrid wallMask() const
+    {
+        MyHouseGrid mask(rows, cols, 0);
+        auto isWall = [this](size_t row, size_t col)
+        {
+            return !contains(row, col) || at(row, col) == WALL_CODE;
+        };
+
+        for (size_t i = 0; i < rows; i++)
+        {
+            for (size_t j = 0; j < cols; j++)
+            {
+                // off the grid wraps around to a huge index, which contains() rejects
+                uint8_t &bits = mask.at(i, j);
+                bits |= isWall(i - 1, j) ? wallBit(Direction::North) : 0;
+                bits |= isWall(i, j + 1) ? wallBit(Direction::East) : 0;
+                bits |= isWall(i + 1, j) ? wallBit(Direction::South) : 0;
+                bits |= isWall(i, j - 1) ? wallBit(Direction::West) : 0;
+                bits |= isWall(i, j) ? WALL_MASK_SELF : 0;
+            }
+        }
+
+        return mask;
+    }
+};
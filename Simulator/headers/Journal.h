@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Results.h"
+
+#define JOURNAL_FILE_NAME "summary.journal"
+
+// Append-only log of finished cells, so a killed or crashed run still leaves its results on disk.
+// The journal starts with the matrix layout ("A <algorithm>" and "H <house>" lines, in order),
+// followed by one "C <algorithm> <house> <state> <score> <numSteps> <dirtLeft> <status> <inDock> <wallTime>"
+// record per finished cell. Every record is a single write() to a file opened with O_APPEND,
+// so workers append concurrently without locking and a record is never split by a crash of the process.
+class MyResultJournal
+{
+    int fd;
+
+private:
+    void writeLine(const string &line);
+
+public:
+    // Constructor - the journal is closed until open() is called
+    MyResultJournal() : fd(-1) {}
+
+    // Deconstructor
+    ~MyResultJournal();
+
+    MyResultJournal(const MyResultJournal &) = delete;
+    MyResultJournal &operator=(const MyResultJournal &) = delete;
+
+    // truncates the journal and writes the matrix layout
+    // returns false if the file can't be opened
+    bool open(const string &path, const vector<string> &algoNames, const vector<string> &houseNames);
+
+    // records a finished cell, safe to call from the pool workers
+    void append(const string &algoName, const string &houseName, const CellResult &result);
+
+    bool isOpen() const { return fd >= 0; }
+
+    // rebuilds the result matrix from a journal, cells missing from it are left not run.
+    // a truncated last line is ignored. throws std::invalid_argument if the file can't be read
+    static MyResultMatrix rebuild(const string &path);
+};
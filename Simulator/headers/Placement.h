@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Utils.h"
+
+#define NUMA_NODES_DIR "/sys/devices/system/node"
+
+enum class PinMode
+{
+    None,
+    Compact, // fill the cores of a node before moving to the next one
+    Scatter, // spread the workers round robin over the nodes
+    List     // the cores given on the command line, in order
+};
+
+// Where every worker runs: a core for each worker slot and the NUMA node of that core.
+// A worker pinned to a core allocates on its own node (Linux places a page on the node that first touches it),
+// so a house parsed by a worker and the simulator state it copies stay local to that worker.
+class MyPlacement
+{
+    vector<int> cpus;  // the core of every worker slot, empty when not pinning
+    vector<int> nodes; // the node of every worker slot
+    size_t nodeCount;
+
+public:
+    // Constructor - no pinning, a single node
+    MyPlacement() : nodeCount(1) {}
+
+    // reads the topology and lays out numWorkers slots.
+    // cpuList is used by PinMode::List. returns false if none of its cores can be used
+    bool init(PinMode mode, size_t numWorkers, const vector<int> &cpuList);
+
+    bool isPinned() const { return !cpus.empty(); }
+    size_t numNodes() const { return nodeCount; }
+
+    // -1 when not pinning
+    int nodeOf(size_t worker) const { return isPinned() ? nodes[worker % nodes.size()] : -1; }
+
+    // pins the calling thread to the core of the worker slot, nothing when not pinning
+    void pin(size_t worker) const;
+};
+
+// parses a cpu list in the sysfs format, "0-3,8,10-11". returns false on a malformed list or a core past CPU_SETSIZE
+bool parseCpuList(const string &value, vector<int> &cpus);
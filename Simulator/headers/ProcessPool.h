@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Placement.h"
+#include "Results.h"
+
+#include <chrono>
+#include <functional>
+#include <sys/types.h>
+
+// slack on top of a task's timeout before its worker is killed,
+// the simulator's own timer handles the algorithms that return from nextStep()
+#define KILL_GRACE_MS 1000
+
+using std::function;
+
+// Pre-forked worker processes for running cells isolated from each other.
+// A crashing algorithm only takes its worker down, and a worker stuck past its task's budget
+// is killed with SIGKILL. Either way the worker is respawned and the next tasks keep flowing.
+// Tasks go to the workers and results come back over pipes, as fixed-size messages.
+// With a memory budget and a placement, tasks are admitted and placed the way MyThreadPool does it.
+class MyProcessPool
+{
+public:
+    // runs a task inside a worker process
+    using TaskRunner = function<CellResult(size_t taskIndex)>;
+    // called in the supervisor when a task is handed to a worker
+    using StartHandler = function<void(size_t taskIndex, size_t worker)>;
+    // called in the supervisor for every finished task
+    using DoneHandler = function<void(size_t taskIndex, const CellResult &result)>;
+    // called in the supervisor for a task whose worker was killed (timedOut) or crashed (signal, 0 if it exited)
+    using LostHandler = function<void(size_t taskIndex, bool timedOut, int signal)>;
+    // called in the supervisor around forking a replacement worker
+    using ForkHandler = function<void()>;
+
+private:
+    struct Worker
+    {
+        pid_t pid = -1;
+        int taskFd = -1;   // supervisor -> worker
+        int resultFd = -1; // worker -> supervisor
+        bool busy = false;
+        size_t taskIndex = 0;
+        size_t memory = 0; // of the running task
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    vector<Worker> workers;
+    TaskRunner runner;
+    size_t memoryBudget; // bytes, 0 for no limit
+    MyPlacement placement;
+    ForkHandler beforeRespawn;
+    ForkHandler afterRespawn;
+
+private:
+    void spawn(Worker &worker);
+    void respawn(Worker &worker);
+    void reap(Worker &worker, bool kill, int *signal);
+    [[noreturn]] void workerLoop(int taskFd, int resultFd);
+
+public:
+    // Constructor - forks the workers. must be called while the process has a single thread
+    MyProcessPool(size_t numWorkers, TaskRunner runner, size_t memoryBudget = 0, const MyPlacement &placement = MyPlacement());
+
+    // Deconstructor - stops and reaps the workers
+    ~MyProcessPool();
+
+    MyProcessPool(const MyProcessPool &) = delete;
+    MyProcessPool &operator=(const MyProcessPool &) = delete;
+
+    // a lost worker is replaced by a fork as well, which again needs a single thread. a supervisor that started
+    // threads since the pool was constructed stops them in before and starts them again in after
+    void onRespawn(ForkHandler before, ForkHandler after)
+    {
+        beforeRespawn = std::move(before);
+        afterRespawn = std::move(after);
+    }
+
+    // runs the tasks in the given order, blocking until all of them are done or lost.
+    // budgetMs gives the time a task may take before its worker is killed, memory its estimated peak bytes
+    // and node the NUMA node whose workers should preferably run it
+    void run(const vector<size_t> &order, const function<double(size_t)> &budgetMs, const function<size_t(size_t)> &memory,
+             const function<int(size_t)> &node, const StartHandler &onStart, const DoneHandler &onDone, const LostHandler &onLost);
+};
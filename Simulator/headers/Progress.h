@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Results.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#define STATS_INTERVAL_MS 1000
+
+// Live progress of a run, rewritten into a stats file every STATS_INTERVAL_MS.
+// Every worker owns a slot of relaxed atomics that only it writes, on its own cache line,
+// so reporting costs the workers no locks and no shared counters. A reporter thread sums the slots.
+// The file is written to "<path>.tmp" and renamed over the path, so a reader never sees half of it.
+class MyRunProgress
+{
+    static constexpr size_t IDLE = static_cast<size_t>(-1);
+
+    struct alignas(64) WorkerSlot
+    {
+        std::atomic<size_t> task{IDLE};
+        std::atomic<int64_t> startNs{0}; // since the run started
+        std::atomic<size_t> done{0};
+        std::atomic<size_t> errors{0};
+        std::atomic<size_t> timeouts{0};
+        std::atomic<size_t> steps{0};
+    };
+
+    string path;
+    vector<string> taskNames; // "<algorithm> <house>" of every task
+    size_t numWorkers;
+    std::unique_ptr<WorkerSlot[]> slots;
+    std::chrono::steady_clock::time_point startTime;
+
+    std::thread reporter;
+    std::mutex mtx;
+    std::condition_variable stopCond;
+    bool stopping;
+
+private:
+    int64_t nowNs() const;
+    void reporterLoop();
+    void writeStats();
+
+public:
+    // Constructor - the reporter starts with startReporting()
+    MyRunProgress(string path, vector<string> taskNames, size_t numWorkers);
+
+    // Deconstructor - stops the reporter and writes the final stats
+    ~MyRunProgress();
+
+    MyRunProgress(const MyRunProgress &) = delete;
+    MyRunProgress &operator=(const MyRunProgress &) = delete;
+
+    // starts the reporter thread. MyProcessPool forks its workers while the process has a single thread,
+    // so the reporter of an isolated run starts once the pool is up, and is stopped while a lost worker is replaced
+    void startReporting();
+
+    // joins the reporter thread, startReporting() starts it again
+    void stopReporting();
+
+    // called by the worker, or on its behalf, when it starts and finishes a task
+    void start(size_t worker, size_t taskIndex);
+    void finish(size_t worker, const CellResult &result);
+};
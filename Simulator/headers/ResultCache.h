@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Results.h"
+
+#include <map>
+#include <mutex>
+
+// Content-addressed store of finished cells.
+// A cell is keyed by a hash of the house file, the algorithm's library, the algorithm name
+// and every configs/*.config file, so a cell is served from the cache as long as none of them changed.
+// An entry is "<key>" holding the result, plus "<key>.txt" holding the output file when it was written.
+class MyResultCache
+{
+    fs::path dir;
+    uint64_t configHash;
+    std::map<fs::path, uint64_t> fileHashes; // memoized, every house and library is hashed once
+    std::mutex mtx;                          // protects fileHashes
+
+private:
+    uint64_t fileHash(const fs::path &path);
+
+public:
+    // Constructor - the cache is disabled until open() is called
+    MyResultCache() : configHash(0) {}
+
+    // returns false if the directory can't be created
+    bool open(const fs::path &cacheDir);
+    bool isOpen() const { return !dir.empty(); }
+
+    string cellKey(const string &algoName, const fs::path &libPath, const fs::path &housePath);
+
+    // returns false on a miss. on a hit with an output file, copies it to outputPath
+    bool lookup(const string &key, CellResult &result, const fs::path *outputPath);
+
+    // stores a finished cell and, when given, its output file. safe to call from the pool workers
+    void store(const string &key, const CellResult &result, const fs::path *outputPath);
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Utils.h"
+
+#define SUMMARY_FILE_NAME "summary.csv"
+#define DETAILED_SUMMARY_FILE_NAME "summary_detailed.csv"
+#define STATS_SUMMARY_FILE_NAME "summary_stats.csv"
+#define SAMPLES_SUMMARY_FILE_NAME "summary_samples.csv"
+#define SWEEP_SUMMARY_FILE_NAME "summary_sweep.csv"
+
+enum class CellState
+{
+    NotRun, // the algorithm couldn't be created, the cell is left empty
+    Error,  // the run ended with an error, the score is the one the error carries
+    Done
+};
+
+// The outcome of one (algorithm, house) run.
+// aligned to a cache line, so workers finishing neighbouring cells don't share one
+struct alignas(64) CellResult
+{
+    CellState state = CellState::NotRun;
+    size_t score = 0;
+    size_t numSteps = 0;
+    size_t dirtLeft = 0;
+    Status status = Status::Working;
+    bool inDock = false;
+    double wallTime = 0; // ms
+    bool timedOut = false; // for the live progress only, not part of the on-disk form
+
+    // the way the cell reads in summary.csv
+    string scoreStr() const { return state == CellState::NotRun ? "" : std::to_string(score); }
+};
+
+// "<state> <score> <numSteps> <dirtLeft> <status> <inDock> <wallTime>", the on-disk form of a result
+string formatCellResult(const CellResult &result);
+
+// reads a result written by formatCellResult. returns false on a malformed result
+bool parseCellResult(std::istream &in, CellResult &result);
+
+// The spread of the scores of the samples of one cell
+struct ScoreStats
+{
+    size_t samples = 0;
+    double mean = 0;
+    size_t min = 0;
+    size_t p50 = 0; // nearest rank percentiles
+    size_t p95 = 0;
+    double stddev = 0; // of the samples, 0 for a single one
+};
+
+ScoreStats computeScoreStats(vector<size_t> scores);
+
+// Preallocated algorithm x house matrix of results.
+// Every cell is written by exactly one task, so the workers write without locking.
+class MyResultMatrix
+{
+    vector<string> algoNames;
+    vector<string> houseNames;
+    vector<CellResult> cells; // row per algorithm
+
+private:
+    // a house is invalid if it scored 0 for every algorithm
+    bool isInvalidHouse(size_t houseIndex) const;
+
+public:
+    // Constructor
+    MyResultMatrix(vector<string> algoNames, vector<string> houseNames);
+
+    CellResult &at(size_t algoIndex, size_t houseIndex) { return cells[algoIndex * houseNames.size() + houseIndex]; }
+    const CellResult &at(size_t algoIndex, size_t houseIndex) const { return cells[algoIndex * houseNames.size() + houseIndex]; }
+
+    size_t numAlgos() const { return algoNames.size(); }
+    size_t numHouses() const { return houseNames.size(); }
+    const string &getAlgoName(size_t algoIndex) const { return algoNames[algoIndex]; }
+    const string &getHouseName(size_t houseIndex) const { return houseNames[houseIndex]; }
+
+    // writes the scores, a row per algorithm and a column per house.
+    // invalid houses are left out, unless this is a partial run to be merged later
+    // returns false if the file can't be opened
+    bool writeCSV(const string &filename, bool removeInvalidHouses = true) const;
+    void writeCSV(std::ostream &file, bool removeInvalidHouses = true) const;
+
+    // writes a row per (algorithm, house) with every metric of the run
+    // returns false if the file can't be opened
+    bool writeDetailedCSV(const string &filename) const;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "House.h"
+#include "StepTrace.h"
+
+#include <map>
+#include <mutex>
+
+#define HISTORY_FILE_NAME "timing.history"
+
+// an unordered_map node of a (y,x) pair with its Point, plus the visited set entry
+#define ALGO_BYTES_PER_CELL 128
+
+// Measured runtimes (ms) of earlier (algorithm, house) runs.
+// The file holds one "<algorithm> <house> <millis>" record per line.
+class MyTimingHistory
+{
+    std::map<pair<string, string>, double> runtimes;
+    std::mutex mtx; // record() is called from the pool workers
+
+public:
+    void load(const string &path);
+    void save(const string &path);
+
+    // returns a negative value if the pair has no history
+    double lookup(const string &algoName, const string &houseName);
+    void record(const string &algoName, const string &houseName, double millis);
+
+    // average ms per unit of proxy cost, over the pairs in the history that are in proxyCosts.
+    // returns 0 if none of them are known
+    double msPerProxyUnit(const std::map<pair<string, string>, double> &proxyCosts);
+};
+
+// Estimates the cost of running one algorithm on one house, before any run.
+// Work grows with the number of steps and, for mapping algorithms, with the house area.
+inline double proxyCost(const HouseHeader &header)
+{
+    return static_cast<double>(header.maxSteps + 1) * static_cast<double>(header.rows * header.cols + 1);
+}
+
+// Estimates the peak memory (bytes) of running one algorithm on one house.
+// The shared house with its wall mask, the simulator's copy of the structure (a byte per padded cell each),
+// the recorded steps (at most 3 bits a step, the rest is in a file),
+// and the algorithm's map of the house, which holds a hashed node per explored cell at worst.
+// The shared house is counted by every task on it, which overestimates but never admits too much.
+inline size_t memoryFootprint(const HouseHeader &header)
+{
+    size_t cells = (header.rows + 2) * (header.cols + 2);
+    size_t grid = cells * sizeof(uint8_t);
+    size_t sharedHouse = 2 * grid; // the structure and its wall mask
+    size_t steps = MyStepTrace::memoryBound(header.maxSteps + 1);
+    size_t algoMap = header.rows * header.cols * ALGO_BYTES_PER_CELL;
+
+    return sharedHouse + grid + steps + algoMap;
+}
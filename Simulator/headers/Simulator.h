@@ -4,11 +4,17 @@
 // #include <boost/bind/bind.hpp>
 
 #include "abstract_algorithm.h"
+#include "snapshot_algorithm.h"
+#include "planning_algorithm.h"
 #include "Utils.h"
+#include "CustomError.h"
+#include "House.h"
 #include "BatteryMeter.h"
 #include "DirtSensor.h"
 #include "WallsSensor.h"
+#include "StepTrace.h"
 #include <chrono>
+#include <optional>
 
 #include <iostream> // error output
 #include <fstream>	// file I/O ops
@@ -33,36 +39,25 @@ enum class FaultCode
 	FROBOT_IN_WALL
 };
 
-enum class ErrOwnership
-{
-	House,
-	Algorithm,
-	Simulator
-};
-
-
-struct CustomError
-{
-	ErrOwnership owner;
-	string content;
-	size_t score;
-	CustomError(ErrOwnership owner, string content, size_t score = 0): owner(owner), content(content), score(score) {}
-};
-
 class MySimulator
 {
 	string houseDescription;
 	size_t rows;						   // House structure's dimensions
 	size_t cols;						   // House structure's dimensions
-	vector<vector<size_t>> houseStructure; // data structure for input house file
-	vector<size_t> dockingLocation;		   // Docking station location in the house (y,x)
-	vector<size_t> currLocation;		   // Robot current location in the house (y,x)
+	MyHouseGrid houseStructure;			   // mutable copy of the shared house structure
+	const MyHouseGrid *wallMask;		   // the walls around every cell, the shared house's
+	pair<size_t, size_t> dockingLocation;  // Docking station location in the house (y,x)
+	pair<size_t, size_t> currLocation;	   // Robot current location in the house (y,x)
 	size_t initDirt;						// Total amount of dirt in the house at the beginning
 	size_t dirtLeft;			   			// Total amount of dirt left in the house 
 	size_t maxSteps;					   // Max steps to accomplish the target
 	double maxBattery;					   // The maximum battery. Always happening: battery <= max_battery
 	double curBattery;					   // The current battey level
 	AbstractAlgorithm *pAlgo;
+	SnapshotAlgorithm *pSnapshotAlgo; // the algorithm, if it takes its readings as a snapshot
+	PlanningAlgorithm *pPlanningAlgo; // the algorithm, if it plans steps ahead
+	StepPlan plan;					 // the algorithm's current plan, steps before planPos were taken
+	size_t planPos;
 	string houseName;
 	string algoName;
 	size_t algoScore;
@@ -79,7 +74,7 @@ class MySimulator
 
 	// Members for tracking after the algorithm
 	size_t numSteps;
-	vector<Step> steps;
+	MyStepTrace steps;
 	Status status;
 
 	uint timeoutCoefficient;
@@ -87,22 +82,47 @@ class MySimulator
     boost::asio::steady_timer timer;
 	bool timeoutOccoured;
 
+	// when the output file was written, both zero if it wasn't
+	std::chrono::steady_clock::time_point outputStart;
+	std::chrono::steady_clock::time_point outputEnd;
+
 private:
-	void houseWallPadding();
 	void writeOutputFile();
 	void tryChargeRobot();
 	void tryToClean();
-	bool isValidLocation(vector<size_t> location) const;
-	void updateTotalDirt();
+	bool isValidLocation(pair<size_t, size_t> location) const;
 	void initLogFile();
-	void handleStep(Step step);
+	// returns the fault that ends the simulation, if the step caused one
+	std::optional<FaultCode> handleStep(Step step);
 	void handleFault(const FaultCode e);
 	void finalize();
-	void updateHouseName(const char* inputName);
 	bool inWall();
 	void activateTimer();
 	void handleErrors();
 
+	// what the sensors read at the robot's location, straight from the simulation's state
+	SensorSnapshot takeSnapshot() const
+	{
+		return {static_cast<uint8_t>(wallMask->at(currLocation.first, currLocation.second) & WALL_MASK_NEIGHBORS),
+				static_cast<int>(houseStructure.at(currLocation.first, currLocation.second)),
+				static_cast<size_t>(curBattery)};
+	}
+
+	// the next planned step, if the plan has one left and none of its stop conditions holds
+	std::optional<Step> nextPlannedStep() const
+	{
+		if (planPos >= plan.steps.size())
+			return std::nullopt;
+
+		int dirt = houseStructure.at(currLocation.first, currLocation.second);
+		if (plan.stopOnDirt && dirt > CLEAN_CODE && dirt <= MAX_DIRT)
+			return std::nullopt;
+		if (plan.stopAtBattery > 0 && batteryMeter.getBatteryState() >= plan.stopAtBattery)
+			return std::nullopt;
+
+		return plan.steps[planPos];
+	}
+
 	// battery handling
 	size_t getMaxBattery() const { return maxBattery; }
 	void chargeBattery() // change battery with max_battery / 20.  if full: doesn't charge
@@ -115,13 +135,15 @@ private:
 		curBattery /= pow(10, 5); 
 	}
 
-	void reduceBattery()
+	// returns false if the battery is already empty
+	bool reduceBattery()
 	{
 		if (curBattery <= 0)
 			// can't reduce battery
-			throw FaultCode::FBATTERY_EXHAUSTED;
+			return false;
 
 		curBattery--;
+		return true;
 	}
 
 	// returns true iff
@@ -132,7 +154,7 @@ private:
 	inline bool isMissionSucceed() const { return dirtLeft == 0 && robotAtDocking(); }
 
 	// returns true iff robot is at the docking station
-	inline bool robotAtDocking() const { return (currLocation[0] == dockingLocation[0] && currLocation[1] == dockingLocation[1]); }
+	inline bool robotAtDocking() const { return currLocation == dockingLocation; }
 
 	//
 	void updateLogFile(Step currStep);
@@ -141,15 +163,32 @@ private:
 	void calcScore();
 
 public:
-	// Constructor
-	MySimulator(string algoName, bool writeOutput, bool writeLog);
+	// Constructor - config holds parameter values that win over Simulator.config
+	MySimulator(string algoName, bool writeOutput, bool writeLog, const ConfigValues *config = nullptr);
 
 	// Deconstructor
 	~MySimulator();
 
-	void readHouseFile(const char *filename);
+	// the house has to outlive the simulation, its walls are read in place
+	void setHouse(const MyHouse &house);
 	void setAlgorithm(AbstractAlgorithm &algo);
 	void run();
 
+	// the parameters of Simulator.config
+	static vector<string> configNames() { return {"timeoutCoefficient"}; }
+
+	// the output file a simulation of the pair writes
+	static string outputFilePath(const string &houseName, const string &algoName)
+	{
+		return OUTPUT_DIR_PATH + houseName + "-" + algoName + ".txt";
+	}
+
 	size_t getScore() const { return algoScore; };
+	size_t getNumSteps() const { return numSteps; }
+	size_t getDirtLeft() const { return dirtLeft; }
+	Status getStatus() const { return status; }
+	bool isInDock() const { return robotAtDocking(); }
+	bool isTimedOut() const { return timeoutOccoured; }
+	std::chrono::steady_clock::time_point getOutputStart() const { return outputStart; }
+	std::chrono::steady_clock::time_point getOutputEnd() const { return outputEnd; }
 };
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "enums.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <vector>
+
+using std::vector;
+
+#define STEP_TRACE_SPILL_BYTES (4 << 20)  // the encoded steps kept in memory before they are moved to a file
+#define STEP_TRACE_READ_CHUNK (64 << 10)
+
+// The steps of a simulation, 3 bits a step, with a repeated step (staying to clean or charge, going straight) collapsed
+// into a run: the step, STEP_TRACE_RUN and the number of repeats, 2 bits in every symbol after it, the third bit set
+// while more follow. A run is written only when it is shorter, so the trace never takes more than 3 bits a step.
+// Past STEP_TRACE_SPILL_BYTES the encoded steps move to an unnamed temporary file, so memory stays bounded whatever
+// MaxSteps is. Recording allocates nothing after the constructor and throws nothing, if the file can't be written the
+// steps stay in memory.
+class MyStepTrace
+{
+    std::FILE *spillFile;
+    size_t spilledBytes;
+    bool spillFailed;
+
+    vector<uint8_t> bytes; // encoded steps not spilled yet
+    uint32_t bits;         // symbols not making up a byte yet
+    unsigned numBits;
+    size_t numSymbols;
+
+    // the step being repeated, runLength times
+    Step runStep;
+    size_t runLength;
+
+private:
+    void writeSymbol(uint8_t symbol);
+    void writeRun();
+    void spill();
+
+public:
+    // Constructor - no steps will be recorded
+    MyStepTrace();
+
+    // Deconstructor - removes the temporary file
+    ~MyStepTrace();
+
+    MyStepTrace(const MyStepTrace &) = delete;
+    MyStepTrace &operator=(const MyStepTrace &) = delete;
+
+    // up to maxSteps steps will be recorded, forgets the recorded ones
+    void reset(size_t maxSteps);
+
+    void push(Step step)
+    {
+        if (runLength > 0 && step == runStep)
+        {
+            runLength++;
+            return;
+        }
+
+        writeRun();
+        runStep = step;
+        runLength = 1;
+    }
+
+    // writes the label of every step, in order. the last call on the trace
+    void writeLabels(std::ostream &out);
+
+    // the bytes kept in memory for a trace of up to maxSteps steps
+    static size_t memoryBound(size_t maxSteps)
+    {
+        size_t encoded = (3 * maxSteps + 7) / 8 + 1;
+        return encoded < STEP_TRACE_SPILL_BYTES ? encoded : STEP_TRACE_SPILL_BYTES;
+    }
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Utils.h"
+
+// A summary.csv loaded as text: a row per algorithm and a column per house.
+// Used to merge the summaries of several partial runs (shards, or selective reruns) into one.
+class MySummaryTable
+{
+    vector<string> algoNames;
+    vector<string> houseNames;
+    vector<vector<string>> cells; // [algorithm][house], empty if the pair didn't run
+
+private:
+    size_t algoIndex(const string &algoName);   // adds the algorithm if it's new
+    size_t houseIndex(const string &houseName); // adds the house if it's new
+
+public:
+    // reads a summary file. throws std::invalid_argument if it can't be read
+    void load(const string &filename);
+
+    // copies every non-empty cell of other over this table,
+    // algorithms and houses that are new to this table are appended in their order in other
+    void merge(const MySummaryTable &other);
+
+    // removes the houses that scored 0 for every algorithm, like a single full run does
+    void removeInvalidHouses();
+
+    // returns false if the file can't be opened
+    bool write(const string &filename) const;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Placement.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::condition_variable;
+using std::function;
+using std::mutex;
+using std::deque;
+using std::thread;
+using std::vector;
+
+// Fixed set of worker threads pulling tasks from a shared queue.
+// Workers are created once and live until the pool is destroyed.
+// With a memory budget, a worker takes the first queued task whose memory fits in what the running
+// tasks left, so a large task waits while the smaller ones behind it keep the other workers busy.
+// With a placement, every worker is pinned to its core and prefers the tasks meant for its NUMA node.
+// A task reports its own errors, an exception it lets escape is dropped and the worker goes on.
+class MyThreadPool
+{
+    struct Task
+    {
+        function<void()> run;
+        size_t memory; // bytes
+        int node;      // the preferred node, -1 for any
+    };
+
+    vector<thread> workers;
+    deque<Task> tasks;
+    mutex mtx;                    // protects tasks, pending, memoryInUse and stopping
+    condition_variable taskCond;  // signaled when a task is queued, memory is freed or the pool stops
+    condition_variable doneCond;  // signaled when the last pending task completes
+    size_t pending;               // tasks queued or running
+    size_t memoryBudget;          // 0 for no limit
+    size_t memoryInUse;           // of the running tasks
+    size_t running;
+    bool stopping;
+    MyPlacement placement;
+
+private:
+    void workerLoop(size_t index);
+
+    static thread_local size_t workerIndex; // of the calling worker thread
+
+    // the first queued task that can be admitted, one for the given node if there is any.
+    // tasks.end() if none. called with mtx held
+    deque<Task>::iterator nextAdmitted(int node);
+
+public:
+    // Constructor
+    MyThreadPool(size_t numThreads, size_t memoryBudget = 0, const MyPlacement &placement = MyPlacement());
+
+    // Deconstructor - waits for the queued tasks and joins the workers
+    ~MyThreadPool();
+
+    MyThreadPool(const MyThreadPool &) = delete;
+    MyThreadPool &operator=(const MyThreadPool &) = delete;
+
+    // memory is the estimated peak bytes of the task, for admission against the memory budget.
+    // node is the NUMA node whose workers should preferably run it
+    void submit(function<void()> task, size_t memory = 0, int node = -1);
+
+    // blocks until every submitted task has completed
+    void wait();
+
+    size_t size() const { return workers.size(); }
+
+    // the index of the worker running the calling task, 0 outside of a pool
+    static size_t currentWorker() { return workerIndex; }
+};
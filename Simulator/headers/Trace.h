@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+// Timeline of a run in Chrome's trace event format (-trace), for chrome://tracing or Perfetto.
+// Every worker is a lane holding a span per task and spans for the phases of the task inside it.
+// Every worker owns a buffer that only it appends to, so recording takes no locks. The buffers are merged into the file
+// when the trace goes out of scope, together with counters of the queued and running tasks derived from the task spans.
+class MyRunTrace
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct Event
+    {
+        const char *name; // a phase, nullptr for the whole task
+        size_t taskIndex;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    struct alignas(64) WorkerBuffer
+    {
+        vector<Event> events;
+    };
+
+    string path;
+    vector<string> taskNames; // "<algorithm> <house>" of every task
+    size_t numWorkers;
+    std::unique_ptr<WorkerBuffer[]> buffers;
+    Clock::time_point startTime;
+
+private:
+    double toUs(Clock::time_point time) const;
+    void writeTrace() const;
+
+public:
+    // Constructor
+    MyRunTrace(string path, vector<string> taskNames, size_t numWorkers);
+
+    // Deconstructor - writes the trace file
+    ~MyRunTrace();
+
+    MyRunTrace(const MyRunTrace &) = delete;
+    MyRunTrace &operator=(const MyRunTrace &) = delete;
+
+    // called by the worker, or on its behalf. name is a string literal, nullptr for the span of the whole task
+    void span(size_t worker, size_t taskIndex, const char *name, Clock::time_point start, Clock::time_point end);
+};
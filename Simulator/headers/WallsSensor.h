@@ -1,22 +1,21 @@
 #pragma once
 
 #include "wall_sensor.h"
-#include "Utils.h"
-
-using MyUtils::calcNewLocation;
+#include "HouseGrid.h"
 
 class MyWallsSensor : public WallsSensor
 {
-    vector<vector<size_t>> &houseStructure;
-    vector<size_t> &currentLocation;
+    const MyHouseGrid *wallMask; // the house's, see MyHouseGrid::wallMask
+    pair<size_t, size_t> &currentLocation;
 
 public:
-    MyWallsSensor(vector<vector<size_t>> &houseStructure, vector<size_t> &currentLocation) : houseStructure(houseStructure), currentLocation(currentLocation) {}
+    MyWallsSensor(pair<size_t, size_t> &currentLocation) : wallMask(nullptr), currentLocation(currentLocation) {}
+
+    // the house being simulated, it has to outlive the readings
+    void setWallMask(const MyHouseGrid &mask) { wallMask = &mask; }
 
     virtual bool isWall(Direction d) const override
     {
-        vector<size_t> newLocation = calcNewLocation(d, currentLocation);
-
-        return houseStructure[newLocation[0]][newLocation[1]] == WALL_CODE;
+        return (wallMask->at(currentLocation.first, currentLocation.second) & wallBit(d)) != 0;
     }
 };
@@ -1,135 +1,172 @@
 #include "AlgorithmRegistrar.h"
+#include "Batch.h"
+#include "Daemon.h"
+#include "Hash.h"
 #include "Simulator.h"
 
+#include "configurable_algorithm.h"
+
 #include <dlfcn.h>
+#include <fnmatch.h>
 #include <fstream>
-#include <thread>
-#include <mutex>
-#include <atomic>
-#include <queue>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
 
-#define ERROR_DIR_PATH "./errors/"
 const string houseExt = ".house";
 const string algoExt = ".so";
 
-using std::mutex;
-using std::thread;
-
-mutex mtx; // mutex to protect share resources
-std::atomic<int> availableThreads(0);
-std::queue<thread> threadQueue;
-
-void writeErrFile(string filename, const string &content)
+// the part of the matrix this node runs, -shard=index/count
+struct Shard
 {
-    fs::create_directories(ERROR_DIR_PATH); // creates the directory if doesn't exists
-    string errFilename = ERROR_DIR_PATH + filename + ".error";
-    ofstream file;
-    file.open(errFilename, std::ios::out | std::ios::trunc);
-    if (!file)
-    {
-        return;
-    }
-
-    file << content << std::endl;
+    size_t index = 0;
+    size_t count = 1;
+};
 
-    file.close();
+// a cell belongs to the shard selected by a stable hash of its names, so every node agrees on the split
+bool inShard(const Shard &shard, const string &algoName, const string &houseFileName)
+{
+    return fnv1a(algoName + "/" + houseFileName) % shard.count == shard.index;
 }
 
-size_t execAlgo(std::unique_ptr<AbstractAlgorithm> algorithm, string housePath, string algoName, bool summaryOnly, bool writeLog)
+// an unsigned number, without a sign or anything after it
+// throws std::invalid_argument or std::out_of_range
+uint64_t parseUnsigned(const string &value)
 {
-    try
-    {
-        MySimulator sim(algoName, !summaryOnly, writeLog);
-
-        sim.readHouseFile(housePath.c_str());
-        sim.setAlgorithm(*algorithm);
-        sim.run();
-        return sim.getScore();
-    }
-    catch (const CustomError &e)
-    {
-        string filename;
-        if (e.owner == ErrOwnership::House)
-        {
-            string houseName(housePath);                                        // converting from const char * to string
-            fs::path filePath(houseName);                                       // converting fron string to fs::path
-            houseName = filePath.filename().string();                           // getting the house name without the path to it
-            filename = houseName.substr(0, houseName.size() - houseExt.size()); // removing the .house suffix
-        }
+    size_t end = 0;
+    if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0])))
+        throw std::invalid_argument("Invalid number (" + value + ")");
 
-        else if (e.owner == ErrOwnership::Algorithm)
-        {
-            filename = algoName;
-        }
+    uint64_t number = std::stoull(value, &end);
+    if (end != value.size())
+        throw std::invalid_argument("Invalid number (" + value + ")");
 
-        else if (e.owner == ErrOwnership::Simulator)
-        {
-            filename = "Simulator";
-        }
-
-        else
-        {
-            filename = "General";
-        }
+    return number;
+}
 
-        writeErrFile(filename, e.content);
+// a size in bytes, with an optional K, M or G suffix (powers of 1024)
+// throws std::invalid_argument or std::out_of_range
+size_t parseByteSize(const string &value)
+{
+    size_t suffixPos = value.find_first_not_of("0123456789");
+    if (suffixPos == string::npos)
+        suffixPos = value.size();
+
+    string suffix = value.substr(suffixPos);
+    size_t shift = 0;
+    if (suffix == "K" || suffix == "k")
+        shift = 10;
+    else if (suffix == "M" || suffix == "m")
+        shift = 20;
+    else if (suffix == "G" || suffix == "g")
+        shift = 30;
+    else if (!suffix.empty())
+        throw std::invalid_argument("Invalid size suffix (" + value + ")");
+
+    uint64_t size = parseUnsigned(value.substr(0, suffixPos));
+    if (size > (SIZE_MAX >> shift))
+        throw std::out_of_range("Size too large (" + value + ")");
+
+    return static_cast<size_t>(size) << shift;
+}
 
-        return e.score;
-    }
+// splits a comma separated list of glob patterns
+vector<string> parsePatterns(const string &value)
+{
+    vector<string> patterns;
+    std::istringstream ss(value);
+    string pattern;
 
-    catch (const std::exception &e)
+    while (getline(ss, pattern, ','))
     {
-        writeErrFile(algoName, e.what());
+        if (!pattern.empty())
+            patterns.push_back(pattern);
     }
 
-    catch (...)
-    {
-        writeErrFile("General", "An error occured in simulator");
-    }
-    return 0;
+    return patterns;
 }
 
-void executeThread(vector<vector<string>> *scores, size_t algoIndex, size_t houseIndex,
-                   std::unique_ptr<AbstractAlgorithm> algorithm, string houseName, string algoName,
-                   bool summaryOnly, bool writeLog)
+// a sweep file has a line per parameter, "<name> <value> [<value>...]". returns every combination of the values,
+// the first value of every parameter first
+vector<ConfigValues> parseSweep(const string &path)
 {
-    auto res = execAlgo(std::move(algorithm), houseName, algoName, summaryOnly, writeLog);
+    std::ifstream file(path);
+    if (!file.is_open())
+        throw std::invalid_argument("Failed to open sweep file (" + path + ")");
 
-    // update scores
-    mtx.lock();
-    (*scores)[algoIndex][houseIndex] = std::to_string(res);
-    availableThreads++;
-    mtx.unlock();
-}
+    vector<ConfigValues> configs = {ConfigValues()};
+    string line;
+    while (getline(file, line))
+    {
+        std::istringstream ss(line);
+        string name, value;
+        if (!(ss >> name))
+            continue;
 
-void writeCSV(const string &filename, const vector<vector<string>> &data)
-{
-    std::ofstream file(filename); // open the file
+        vector<string> values;
+        while (ss >> value)
+            values.push_back(value);
+        if (values.empty())
+            throw std::invalid_argument("No values for " + name + " in sweep file (" + path + ")");
 
-    if (!file.is_open())
-    {
-        writeErrFile("csv", "Failed to open csv file");
-        return;
+        vector<ConfigValues> expanded;
+        for (const auto &config : configs)
+        {
+            for (const auto &v : values)
+            {
+                expanded.push_back(config);
+                expanded.back()[name] = v;
+            }
+        }
+        configs = std::move(expanded);
     }
 
-    for (size_t i = 0; i < data.size(); ++i)
+    return configs;
+}
+
+// the swept parameters that neither the simulator nor any of the algorithms knows, sweeping them changes nothing
+vector<string> unusedSweepParams(const vector<ConfigValues> &configs, const AlgorithmRegistrar &algos)
+{
+    std::set<string> known;
+    for (const auto &name : MySimulator::configNames())
+        known.insert(name);
+
+    for (const auto &algo : algos)
     {
-        const auto &row = data[i];
-        for (size_t j = 0; j < row.size(); ++j)
+        try
         {
-            file << row[j];
-            if (j < row.size() - 1)
-            {
-                file << ",";
-            }
+            auto instance = algo.create();
+            auto *configurable = dynamic_cast<ConfigurableAlgorithm *>(instance.get());
+            if (configurable == nullptr)
+                continue;
+            for (const auto &name : configurable->configNames())
+                known.insert(name);
+        }
+        catch (const std::exception &e)
+        {
+            // the algorithm's cells report it
         }
-        file << "\n";
     }
 
-    file.close();
+    vector<string> unused;
+    for (const auto &param : configs.front())
+    {
+        if (known.count(param.first) == 0)
+            unused.push_back(param.first);
+    }
+    return unused;
 }
 
-void handleCLIArguments(int argc, char **argv, string *housePath, string *algoPath, size_t *numThreads, bool *summaryOnly, bool *writeLog)
+void handleCLIArguments(int argc, char **argv, string *housePath, string *algoPath, size_t *numThreads, bool *summaryOnly, bool *writeLog,
+                        string *historyPath, bool *detailedSummary, string *journalPath, bool *rebuildSummary, Shard *shard,
+                        string *cacheDir, bool *isolate, size_t *memoryBudget, PinMode *pinMode, vector<int> *pinCpus,
+                        string *statsPath, string *tracePath, bool *daemon, string *socketPath,
+                        vector<string> *algoPatterns, vector<string> *housePatterns, size_t *repeats, std::optional<uint64_t> *seed,
+                        string *sweepPath)
 {
     for (int i = 1; i < argc; ++i)
     {
@@ -141,22 +178,126 @@ void handleCLIArguments(int argc, char **argv, string *housePath, string *algoPa
             string key = arg.substr(0, pos);
             string value = arg.substr(pos + 1);
 
-            if (key.compare("-house_path") == 0)
+            // an invalid value is reported, and the flag keeps its default
+            try
             {
-                *housePath = value;
-            }
+                if (key.compare("-house_path") == 0)
+                {
+                    *housePath = value;
+                }
 
-            if (key.compare("-algo_path") == 0)
-            {
-                *algoPath = value;
-            }
+                if (key.compare("-algo_path") == 0)
+                {
+                    *algoPath = value;
+                }
 
-            if (key.compare("-num_thread") == 0)
-            {
-                if (std::stoul(value) > 0)
+                if (key.compare("-num_thread") == 0)
+                {
+                    if (parseUnsigned(value) > 0)
+                    {
+                        *numThreads = parseUnsigned(value);
+                    }
+                }
+
+                if (key.compare("-history") == 0)
+                {
+                    *historyPath = value;
+                }
+
+                if (key.compare("-journal") == 0)
+                {
+                    *journalPath = value;
+                }
+
+                if (key.compare("-cache") == 0)
+                {
+                    *cacheDir = value;
+                }
+
+                if (key.compare("-repeats") == 0)
+                {
+                    if (parseUnsigned(value) > 0)
+                    {
+                        *repeats = parseUnsigned(value);
+                    }
+                }
+
+                if (key.compare("-seed") == 0)
+                {
+                    *seed = parseUnsigned(value);
+                }
+
+                if (key.compare("-sweep") == 0)
                 {
-                    *numThreads = std::stoul(value);
+                    *sweepPath = value;
                 }
+
+                if (key.compare("-algos") == 0)
+                {
+                    *algoPatterns = parsePatterns(value);
+                }
+
+                if (key.compare("-houses") == 0)
+                {
+                    *housePatterns = parsePatterns(value);
+                }
+
+                if (key.compare("-socket") == 0)
+                {
+                    *socketPath = value;
+                }
+
+                if (key.compare("-stats") == 0)
+                {
+                    *statsPath = value;
+                }
+
+                if (key.compare("-trace") == 0)
+                {
+                    *tracePath = value;
+                }
+
+                if (key.compare("-mem_budget") == 0)
+                {
+                    *memoryBudget = parseByteSize(value);
+                }
+
+                if (key.compare("-pin") == 0)
+                {
+                    // compact, scatter or a list of cores
+                    vector<int> cpus;
+                    if (value.compare("compact") == 0)
+                        *pinMode = PinMode::Compact;
+                    else if (value.compare("scatter") == 0)
+                        *pinMode = PinMode::Scatter;
+                    else if (parseCpuList(value, cpus) && !cpus.empty())
+                    {
+                        *pinMode = PinMode::List;
+                        *pinCpus = std::move(cpus);
+                    }
+                    else
+                        throw std::invalid_argument("Invalid core list");
+                }
+
+                if (key.compare("-shard") == 0)
+                {
+                    // index/count, an invalid value keeps running the whole matrix
+                    size_t slash = value.find('/');
+                    if (slash != string::npos)
+                    {
+                        size_t index = parseUnsigned(value.substr(0, slash));
+                        size_t count = parseUnsigned(value.substr(slash + 1));
+                        if (count > 0 && index < count)
+                        {
+                            shard->index = index;
+                            shard->count = count;
+                        }
+                    }
+                }
+            }
+            catch (const std::logic_error &e)
+            {
+                writeErrFile(key.substr(1), "Invalid value for " + key + " (" + value + ")");
             }
         }
 
@@ -169,14 +310,40 @@ void handleCLIArguments(int argc, char **argv, string *housePath, string *algoPa
         {
             *writeLog = true;
         }
+
+        if (arg.compare("-detailed_summary") == 0)
+        {
+            *detailedSummary = true;
+        }
+
+        if (arg.compare("-daemon") == 0)
+        {
+            *daemon = true;
+        }
+
+        if (arg.compare("-isolate") == 0)
+        {
+            *isolate = true;
+        }
+
+        if (arg.compare("-rebuild_summary") == 0)
+        {
+            *rebuildSummary = true;
+        }
     }
 }
 
-void loadLibs(vector<void *> *libsHandle, vector<std::filesystem::path> &algoLibNames)
+// algoLibs gets the library of every registered algorithm, in registration order
+void loadLibs(vector<void *> *libsHandle, vector<std::filesystem::path> &algoLibNames, vector<fs::path> *algoLibs)
 {
     for (const auto &lib : algoLibNames)
     {
         void *handle = dlopen(lib.c_str(), RTLD_GLOBAL | RTLD_NOW);
+
+        // the algorithms the library registered while loading
+        while (algoLibs->size() < AlgorithmRegistrar::getAlgorithmRegistrar().count())
+            algoLibs->push_back(lib);
+
         if (handle == nullptr)
         {
             string filename = lib.filename().string();
@@ -190,15 +357,32 @@ void loadLibs(vector<void *> *libsHandle, vector<std::filesystem::path> &algoLib
     }
 }
 
-// return vector of files from directort that has specific extension
+// a file matches if its name, with or without the extension, matches one of the patterns. no patterns match everything
+bool matchesAny(const fs::path &file, const vector<string> &patterns)
+{
+    if (patterns.empty())
+        return true;
+
+    string filename = file.filename().string();
+    string stem = file.stem().string();
+    for (const auto &pattern : patterns)
+    {
+        if (fnmatch(pattern.c_str(), stem.c_str(), 0) == 0 || fnmatch(pattern.c_str(), filename.c_str(), 0) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+// return vector of files from directort that has specific extension and match the patterns
 // pre: directory is an existing directory
-vector<fs::path> fetchFiles(string directory, string extension)
+vector<fs::path> fetchFiles(string directory, string extension, const vector<string> &patterns)
 {
     vector<fs::path> files;
 
     for (const auto &entry : fs::directory_iterator(directory))
     {
-        if (entry.is_regular_file() && entry.path().extension() == extension)
+        if (entry.is_regular_file() && entry.path().extension() == extension && matchesAny(entry.path(), patterns))
         {
             files.push_back(entry.path());
         }
@@ -208,7 +392,7 @@ vector<fs::path> fetchFiles(string directory, string extension)
 }
 
 // return vector of files that has .house extension
-vector<fs::path> fetchHouseNames(string housePath)
+vector<fs::path> fetchHouseNames(string housePath, const vector<string> &patterns)
 {
     if (!fs::exists(housePath))
     {
@@ -221,11 +405,11 @@ vector<fs::path> fetchHouseNames(string housePath)
         return {};
     }
 
-    return fetchFiles(housePath, houseExt);
+    return fetchFiles(housePath, houseExt, patterns);
 }
 
 // return vector of files that has .so extension
-vector<fs::path> fetchAlgoLibraries(string algoPath)
+vector<fs::path> fetchAlgoLibraries(string algoPath, const vector<string> &patterns)
 {
     if (!fs::exists(algoPath))
     {
@@ -238,122 +422,295 @@ vector<fs::path> fetchAlgoLibraries(string algoPath)
         return {};
     }
 
-    return fetchFiles(algoPath, algoExt);
+    return fetchFiles(algoPath, algoExt, patterns);
+}
+
+// writes the summary files of a result matrix.
+// a partial run (a shard, or a run of some of the algorithms or houses) keeps the invalid houses,
+// they are only known once the partial summaries are merged
+void writeSummaries(const MyResultMatrix &results, const string &csvFileName, bool detailedSummary, bool partial)
+{
+    if (!results.writeCSV(csvFileName, !partial))
+        writeErrFile("csv", "Failed to open csv file");
+
+    if (detailedSummary && !results.writeDetailedCSV(DETAILED_SUMMARY_FILE_NAME))
+        writeErrFile("csv", "Failed to open detailed csv file");
 }
 
-void removeInvalidHouseFromScores(vector<vector<string>> &data)
+// the results of every cell, a repeated cell is its first sample with the mean score of all of them.
+// a sweep only reports its first point here
+MyResultMatrix collectResults(const vector<BatchResult> &cells, const vector<string> &algoNames, const vector<string> &houseNames)
 {
-    size_t numRows = data.size();
-    size_t numCols = data[0].size();
+    MyResultMatrix results(algoNames, houseNames);
+    std::map<pair<size_t, size_t>, vector<size_t>> scores;
 
-    // Iterate over each column (from last to first to avoid issues with removing)
-    for (size_t col = numCols; col > 0; col--)
+    for (const auto &cell : cells)
     {
-        bool isEmpty = true;
+        if (cell.config != 0)
+            continue;
+
+        if (cell.sample == 0)
+            results.at(cell.algoIndex, cell.houseIndex) = cell.result;
+        scores[{cell.algoIndex, cell.houseIndex}].push_back(cell.result.score);
+    }
 
-        // Iterate over the rows to check if the column has only empty strings
-        for (size_t row = 1; row < numRows; ++row)
+    for (const auto &[index, cellScores] : scores)
+    {
+        if (cellScores.size() > 1)
+            results.at(index.first, index.second).score = static_cast<size_t>(std::llround(computeScoreStats(cellScores).mean));
+    }
+
+    return results;
+}
+
+// writes the statistics of every cell, and every sample with its seed, so a single sample can be rerun with -seed
+// returns false if a file can't be opened
+bool writeSampleSummaries(const vector<BatchResult> &cells, const vector<string> &algoNames, const vector<string> &houseNames)
+{
+    std::ofstream statsFile(STATS_SUMMARY_FILE_NAME);
+    std::ofstream samplesFile(SAMPLES_SUMMARY_FILE_NAME);
+    if (!statsFile.is_open() || !samplesFile.is_open())
+        return false;
+
+    statsFile << "Algorithm,House,Samples,Mean,Min,P50,P95,Stddev\n";
+    samplesFile << "Algorithm,House,Sample,Seed,Score,Error\n";
+
+    // the cells come by algorithm, house and sample
+    for (size_t first = 0; first < cells.size();)
+    {
+        size_t last = first;
+        vector<size_t> scores;
+        for (; last < cells.size() && cells[last].algoIndex == cells[first].algoIndex && cells[last].houseIndex == cells[first].houseIndex; last++)
         {
-            if (data[row][col - 1] != "0")
-            {
-                isEmpty = false;
-                break;
-            }
+            const BatchResult &cell = cells[last];
+            if (cell.result.state == CellState::NotRun || cell.config != 0)
+                continue;
+
+            scores.push_back(cell.result.score);
+            samplesFile << algoNames[cell.algoIndex] << "," << houseNames[cell.houseIndex] << "," << cell.sample << ","
+                        << (cell.seeded ? std::to_string(cell.seed) : ""s) << "," << cell.result.score << ","
+                        << (cell.result.state == CellState::Error ? "TRUE" : "FALSE") << "\n";
         }
 
-        // If the column has only empty strings, remove it from all rows
-        if (isEmpty)
+        if (!scores.empty())
         {
-            for (size_t row = 0; row < numRows; ++row)
-            {
-                data[row].erase(data[row].begin() + (col - 1));
-            }
+            ScoreStats stats = computeScoreStats(scores);
+            statsFile << algoNames[cells[first].algoIndex] << "," << houseNames[cells[first].houseIndex] << "," << stats.samples << ","
+                      << stats.mean << "," << stats.min << "," << stats.p50 << "," << stats.p95 << "," << stats.stddev << "\n";
         }
+
+        first = last;
     }
+
+    return true;
 }
 
-int main(int argc, char **argv)
+// writes the mean score of every cell at every point of the sweep, a column per parameter.
+// returns false if the file can't be opened
+bool writeSweepSummary(const vector<BatchResult> &cells, const vector<ConfigValues> &configs, const vector<string> &algoNames,
+                       const vector<string> &houseNames)
 {
-    vector<vector<string>> scores; // vector to write to CSV
+    std::ofstream file(SWEEP_SUMMARY_FILE_NAME);
+    if (!file.is_open())
+        return false;
+
+    file << "Algorithm,House";
+    for (const auto &[name, value] : configs.front())
+        file << "," << name;
+    file << ",Score,Error\n";
+
+    // the cells come by algorithm, house, config and sample
+    for (size_t first = 0; first < cells.size();)
+    {
+        size_t last = first;
+        vector<size_t> scores;
+        bool error = false;
+        for (; last < cells.size() && cells[last].algoIndex == cells[first].algoIndex && cells[last].houseIndex == cells[first].houseIndex &&
+               cells[last].config == cells[first].config;
+             last++)
+        {
+            if (cells[last].result.state == CellState::NotRun)
+                continue;
+
+            scores.push_back(cells[last].result.score);
+            error = error || cells[last].result.state == CellState::Error;
+        }
 
+        if (!scores.empty())
+        {
+            file << algoNames[cells[first].algoIndex] << "," << houseNames[cells[first].houseIndex];
+            for (const auto &[name, value] : configs[cells[first].config])
+                file << "," << value;
+            file << "," << computeScoreStats(scores).mean << "," << (error ? "TRUE" : "FALSE") << "\n";
+        }
+
+        first = last;
+    }
+
+    return true;
+}
+
+// rebuilds the summary files from the journal of an earlier (possibly killed) run, without running anything
+int rebuildSummary(const string &journalPath, const string &csvFileName, bool detailedSummary, bool partial)
+{
+    try
+    {
+        writeSummaries(MyResultJournal::rebuild(journalPath), csvFileName, detailedSummary, partial);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        writeErrFile("journal", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv)
+{
     string housePath = "./";
     string algoPath = "./";
     size_t numThreads = 10;
     bool summaryOnly = false;
     bool writeLog = false;
-    string csvFileName = "summary.csv";
+    bool detailedSummary = false;
+    string csvFileName = SUMMARY_FILE_NAME;
+    string historyPath = HISTORY_FILE_NAME;
+    string journalPath = JOURNAL_FILE_NAME;
+    bool rebuildOnly = false;
+    Shard shard;
+    string cacheDir = "";
+    bool isolate = false;
+    size_t memoryBudget = 0;
+    PinMode pinMode = PinMode::None;
+    vector<int> pinCpus;
+    string statsPath = "";
+    string tracePath = "";
+    bool daemon = false;
+    string socketPath = DAEMON_SOCKET_NAME;
+    vector<string> algoPatterns;
+    vector<string> housePatterns;
+    size_t repeats = 1;
+    std::optional<uint64_t> seed;
+    string sweepPath = "";
 
     // handling command line arguments
-    handleCLIArguments(argc, argv, &housePath, &algoPath, &numThreads, &summaryOnly, &writeLog);
-    availableThreads = numThreads;
+    handleCLIArguments(argc, argv, &housePath, &algoPath, &numThreads, &summaryOnly, &writeLog, &historyPath, &detailedSummary,
+                       &journalPath, &rebuildOnly, &shard, &cacheDir, &isolate, &memoryBudget, &pinMode,
+                       &pinCpus, &statsPath, &tracePath, &daemon, &socketPath,
+                       &algoPatterns, &housePatterns, &repeats, &seed, &sweepPath);
+    bool partial = shard.count > 1 || !algoPatterns.empty() || !housePatterns.empty();
 
-    auto houseNames = fetchHouseNames(housePath);
-    auto algoLibNames = fetchAlgoLibraries(algoPath);
+    if (rebuildOnly)
+        return rebuildSummary(journalPath, csvFileName, detailedSummary, partial);
 
-    // adding the house names to the scores as headlines of the columns
-    vector<string> vec;
-    vec.push_back("Algorithms");
-    for (const auto &housePath : houseNames)
+    // a daemon runs every algorithm it finds on every house, in threads and once per cell
+    if (daemon && (!algoPatterns.empty() || !housePatterns.empty() || shard.count > 1 || isolate || !sweepPath.empty()))
     {
-        string houseName = housePath.filename().string();
-        vec.push_back(houseName.substr(0, houseName.size() - houseExt.size()));
+        writeErrFile("daemon", "-algos, -houses, -shard, -isolate and -sweep can't be used with -daemon");
+        return EXIT_FAILURE;
+    }
+
+    BatchOptions options;
+    options.numThreads = numThreads;
+    options.writeOutput = !summaryOnly;
+    options.writeLog = writeLog;
+    options.writeErrors = true;
+    options.memoryBudget = memoryBudget;
+    options.isolate = isolate;
+    options.statsPath = statsPath;
+    options.tracePath = tracePath;
+    options.repeats = repeats;
+    options.seed = seed;
+    if (!sweepPath.empty())
+    {
+        try
+        {
+            options.configs = parseSweep(sweepPath);
+        }
+        catch (const std::invalid_argument &e)
+        {
+            writeErrFile("sweep", e.what());
+            return EXIT_FAILURE;
+        }
     }
-    scores.push_back(vec);
+    vector<ConfigValues> configs = options.configs;
+    if (!options.placement.init(pinMode, numThreads, pinCpus))
+        writeErrFile("pin", "None of the given cores can be used, the workers are not pinned");
+
+    MyTimingHistory history;
+    history.load(historyPath);
+
+    MyResultCache cache;
+    if (!cacheDir.empty() && !cache.open(cacheDir))
+        writeErrFile("cache", "Failed to create cache directory");
+
+    options.history = &history;
+    options.cache = cache.isOpen() ? &cache : nullptr;
+
+    if (daemon)
+    {
+        MyDaemon resident(std::move(options), housePath, algoPath, socketPath, csvFileName, historyPath, detailedSummary);
+        return resident.run();
+    }
+
+    // only the libraries that match are loaded at all
+    auto houseNames = fetchHouseNames(housePath, housePatterns);
+    auto algoLibNames = fetchAlgoLibraries(algoPath, algoPatterns);
 
     // Loading the libraries and register the algorithms
     vector<void *> libsHandle;
-    loadLibs(&libsHandle, algoLibNames);
+    vector<fs::path> algoLibs;
+    loadLibs(&libsHandle, algoLibNames, &algoLibs);
 
     // running each algo on each house
     auto algos = AlgorithmRegistrar::getAlgorithmRegistrar();
 
-    // Initializing the scores vector to empty strings
-    for (const auto &algo : algos)
+    if (!configs.empty())
     {
-        vector<string> vec(houseNames.size() + 1, "");
-        vec[0] = algo.name();
-        scores.push_back(vec);
+        for (const auto &name : unusedSweepParams(configs, algos))
+            writeErrFile("sweep", "No algorithm and not the simulator use " + name + ", sweeping it changes nothing");
     }
 
-    size_t i = 0;
-    for (const auto &algo : algos)
+    // the workers stream every finished cell into the journal
+    MyResultJournal journal;
+    options.journal = &journal;
+    options.filter = [&algos, &houseNames, &shard](size_t algoIndex, size_t houseIndex)
     {
-        // going through the houses and running the simulation
-        for (size_t j = 0; j < houseNames.size(); ++j)
-        {
-            auto algoFactory = algo;     // store the factory to create multiple instances
-            auto algoName = algo.name(); // get the algorithm's name
+        return inShard(shard, (algos.begin() + algoIndex)->name(), houseNames[houseIndex].filename().string());
+    };
 
-            while (availableThreads == 0)
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            }
+    vector<BatchResult> batchResults;
+    vector<string> algoNames, houseTitles;
+    {
+        MySimulatorBatch batch(std::move(options));
 
-            availableThreads--;
-            try
-            {
-                auto algorithm = algoFactory.create();
-                thread t(executeThread, &scores, i + 1, j + 1, std::move(algorithm),
-                         houseNames[j].string(), algoName, summaryOnly, writeLog);
-                threadQueue.push(std::move(t));
-            }
-            catch (const std::exception &e)
-            {
-                writeErrFile(algoName, e.what());
-            }
+        // the factories capture entries of algos, main's own copy of the registrar, by reference. the batch is gone
+        // before algos is cleared, and clearing the registrar itself leaves the copy alone
+        size_t algoIndex = 0;
+        for (const auto &algo : algos)
+        {
+            batch.addAlgorithm(algo.name(), [&algo]
+                               { return algo.create(); },
+                               algoIndex < algoLibs.size() ? algoLibs[algoIndex] : fs::path());
+            algoIndex++;
         }
 
-        i++;
-    }
+        // the house names without the .house suffix are the headlines of the columns
+        for (const auto &house : houseNames)
+            batch.addHouse(house);
 
-    // Waiting for all threads to finish
-    while (!threadQueue.empty())
-    {
-        thread t = std::move(threadQueue.front());
-        t.join();
-        threadQueue.pop();
+        algoNames = batch.getAlgoNames();
+        houseTitles = batch.getHouseNames();
+
+        if (!journal.open(journalPath, algoNames, houseTitles))
+            writeErrFile("journal", "Failed to open journal file");
+
+        batchResults = batch.run();
     }
 
+    history.save(historyPath);
+
     algos.clear();
     AlgorithmRegistrar::getAlgorithmRegistrar().clear();
     houseNames.clear();
@@ -365,11 +722,14 @@ int main(int argc, char **argv)
         dlclose(handle);
     }
 
-    // remove from scores the invalid houses if there are any
-    removeInvalidHouseFromScores(scores);
+    MyResultMatrix results = collectResults(batchResults, algoNames, houseTitles);
+    if (repeats > 1 && !writeSampleSummaries(batchResults, algoNames, houseTitles))
+        writeErrFile("csv", "Failed to open the samples csv files");
+    if (!configs.empty() && !writeSweepSummary(batchResults, configs, algoNames, houseTitles))
+        writeErrFile("csv", "Failed to open the sweep csv file");
 
-    // writing the csv summary file
-    writeCSV(csvFileName, scores);
+    // writing the csv summary files
+    writeSummaries(results, csvFileName, detailedSummary, partial);
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
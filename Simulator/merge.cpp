@@ -0,0 +1,54 @@
+#include "Summary.h"
+
+// Merges the summary files of several partial runs (e.g. myrobot -shard=i/n on every node)
+// into one summary, identical to the summary of a single full run.
+// usage: myrobot_merge [-output=<file>] <summary.csv> [<summary.csv> ...]
+// later files win where several files have a score for the same pair
+int main(int argc, char **argv)
+{
+    string outputName = "summary.csv";
+    vector<string> inputNames;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        size_t pos = arg.find('=');
+
+        if (pos != string::npos && arg.substr(0, pos).compare("-output") == 0)
+            outputName = arg.substr(pos + 1);
+        else
+            inputNames.push_back(arg);
+    }
+
+    if (inputNames.empty())
+    {
+        std::cerr << "usage: " << argv[0] << " [-output=<file>] <summary.csv> [<summary.csv> ...]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    MySummaryTable merged;
+    try
+    {
+        for (const auto &inputName : inputNames)
+        {
+            MySummaryTable table;
+            table.load(inputName);
+            merged.merge(table);
+        }
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    merged.removeInvalidHouses();
+
+    if (!merged.write(outputName))
+    {
+        std::cerr << "Error: Failed to open output file (" << outputName << ")" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
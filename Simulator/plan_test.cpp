@@ -0,0 +1,89 @@
+#include "Simulator.h"
+
+// walks a corridor with plans: east until the dirt stops it, cleans, back to the dock, and charges until the battery
+// is full. remembers the length of every plan that ended
+class CorridorAlgorithm : public AbstractAlgorithm, public PlanningAlgorithm
+{
+    StepPlan *plan = nullptr;
+    size_t maxBattery = 0;
+    size_t calls = 0;
+
+public:
+    vector<size_t> planLengths;
+
+    virtual void setMaxSteps(size_t) override {}
+    virtual void setWallsSensor(const WallsSensor &) override {}
+    virtual void setDirtSensor(const DirtSensor &) override {}
+    virtual void setBatteryMeter(const BatteryMeter &meter) override { maxBattery = meter.getBatteryState(); }
+    virtual void setPlan(StepPlan &plan) override { this->plan = &plan; }
+    virtual void planEnded(size_t executed) override { planLengths.push_back(executed); }
+
+    virtual Step nextStep() override
+    {
+        switch (calls++)
+        {
+        case 0:
+            *plan = {{Step::East, Step::East, Step::East, Step::East}, true, 0};
+            return Step::East;
+        case 1:
+            *plan = {vector<Step>(5, Step::Stay), false, 0};
+            return Step::Stay;
+        case 2:
+            *plan = {{Step::West, Step::West}, false, 0};
+            return Step::West;
+        case 3:
+            *plan = {vector<Step>(20, Step::Stay), false, maxBattery}; // more than a charge takes
+            return Step::Stay;
+        default:
+            return Step::Finish;
+        }
+    }
+};
+
+// a corridor east of the dock, with dirt on its third cell
+fs::path writeHouse()
+{
+    fs::path path = fs::temp_directory_path() / "plan_test.house";
+    std::ofstream(path) << "Corridor\nMaxSteps = 100\nMaxBattery = 100\nRows = 1\nCols = 6\nD00300\n";
+    return path;
+}
+
+// checks that the simulator takes the planned steps itself, ends a plan on its stop conditions, and reports how much
+// of every plan was taken
+int main()
+{
+    try
+    {
+        fs::path housePath = writeHouse();
+        MyHouse house(housePath);
+        fs::remove(housePath);
+
+        ConfigValues config = {{"timeoutCoefficient", "1000"}};
+        MySimulator sim("CorridorAlgorithm", false, false, &config);
+        CorridorAlgorithm algo;
+        sim.setHouse(house);
+        sim.setAlgorithm(algo);
+        sim.run();
+
+        // the dirt stops the walk after 2 of 4 steps, the cleaning and the way back run out, and the charge stops
+        // when the battery is full: 88 after 12 steps, 93 after the first Stay, 2 more to 100
+        vector<size_t> expected = {2, 5, 2, 2};
+        std::cout << "plans taken:";
+        for (size_t length : algo.planLengths)
+            std::cout << " " << length;
+        std::cout << ", " << sim.getNumSteps() << " steps, " << sim.getDirtLeft() << " dirt left" << std::endl;
+
+        if (algo.planLengths != expected || sim.getNumSteps() != 15 || sim.getDirtLeft() != 0 || !sim.isInDock())
+        {
+            std::cerr << "the plans weren't taken as planned" << std::endl;
+            return 1;
+        }
+    }
+    catch (const CustomError &e)
+    {
+        std::cerr << e.content << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
@@ -0,0 +1,754 @@
+#include "Batch.h"
+#include "Simulator.h"
+#include "ThreadPool.h"
+#include "ProcessPool.h"
+#include "Progress.h"
+#include "Trace.h"
+
+#include "seeded_algorithm.h"
+#include "configurable_algorithm.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <random>
+
+namespace
+{
+    // one (algorithm, house) cell of the matrix
+    struct Task
+    {
+        size_t algoIndex;
+        size_t houseIndex;
+        double cost;   // estimated runtime, used for ordering only
+        size_t memory; // estimated peak bytes, used for admission against the memory budget
+        int node;      // the NUMA node of the workers that should run it, -1 for any
+        size_t config; // the index in BatchOptions::configs, 0 without a sweep
+        size_t sample;
+        bool seeded; // the algorithm is given seed before it runs
+        uint64_t seed;
+    };
+
+    // the state shared by every task of a run
+    struct RunContext
+    {
+        const BatchOptions *options;
+        vector<AlgorithmFactory> algoFactories;
+        vector<string> algoNames;
+        vector<fs::path> algoLibs;
+        vector<string> houseNames;
+        vector<fs::path> housePaths; // empty for the houses given parsed without their file
+        vector<bool> housesParsed;   // the houses given parsed
+        vector<unique_ptr<MyHouseLoader>> houseLoaders;
+        vector<HouseHeader> houseHeaders;
+        MyRunProgress *progress; // nullptr unless statsPath is given
+        MyRunTrace *trace;       // nullptr unless tracePath is given
+
+        // the samples of every journaled cell (the first point of a sweep), the last one to finish journals the cell
+        vector<size_t> taskCell; // the cell of every task, SIZE_MAX for the other points of a sweep
+        vector<vector<size_t>> cellTasks;
+        unique_ptr<std::atomic<size_t>[]> samplesLeft;
+    };
+
+    // the phases of one task on its worker's lane, nothing is recorded without a trace
+    struct TaskTrace
+    {
+        MyRunTrace *trace = nullptr;
+        size_t worker = 0;
+        size_t taskIndex = 0;
+
+        MyRunTrace::Clock::time_point now() const
+        {
+            return trace != nullptr ? MyRunTrace::Clock::now() : MyRunTrace::Clock::time_point();
+        }
+
+        void span(const char *name, MyRunTrace::Clock::time_point start, MyRunTrace::Clock::time_point end) const
+        {
+            if (trace != nullptr)
+                trace->span(worker, taskIndex, name, start, end);
+        }
+
+        // a phase that started at start and ends now
+        void span(const char *name, MyRunTrace::Clock::time_point start) const
+        {
+            if (trace != nullptr)
+                trace->span(worker, taskIndex, name, start, now());
+        }
+    };
+}
+
+// the parameters the task runs with, nullptr for the config files
+static const ConfigValues *taskConfig(const Task &task, const RunContext &ctx)
+{
+    return ctx.options->configs.empty() ? nullptr : &ctx.options->configs[task.config];
+}
+
+static void identifyCell(BatchResult &cell, const Task &task)
+{
+    cell.algoIndex = task.algoIndex;
+    cell.houseIndex = task.houseIndex;
+    cell.config = task.config;
+    cell.sample = task.sample;
+    cell.seeded = task.seeded;
+    cell.seed = task.seed;
+}
+
+// the error of a cell, written to its .error file when asked
+static void reportError(BatchResult &cell, const string &owner, const string &content, const RunContext &ctx,
+                        const TaskTrace &tracer = TaskTrace())
+{
+    auto start = tracer.now();
+    cell.errorOwner = owner;
+    cell.error = content;
+
+    if (ctx.options->writeErrors)
+        writeErrFile(owner, content);
+    tracer.span("error", start);
+}
+
+// copies the metrics of a simulation that ran into its result cell
+static void collectResult(const MySimulator &sim, CellResult &result)
+{
+    result.score = sim.getScore();
+    result.numSteps = sim.getNumSteps();
+    result.dirtLeft = sim.getDirtLeft();
+    result.status = sim.getStatus();
+    result.inDock = sim.isInDock();
+    result.timedOut = sim.isTimedOut();
+}
+
+static void execAlgo(std::unique_ptr<AbstractAlgorithm> algorithm, MyHouseLoader &houseLoader, const string &algoName,
+                     const string &houseName, bool writeFiles, const ConfigValues *config, BatchResult &cell, const RunContext &ctx,
+                     const TaskTrace &tracer)
+{
+    CellResult &result = cell.result;
+    std::optional<MySimulator> sim;
+    bool ran = false;
+    MyRunTrace::Clock::time_point simStart;
+
+    // the simulation's span, and the output file's inside it
+    auto traceSimulation = [&sim, &simStart, &tracer]
+    {
+        tracer.span("simulate", simStart);
+        if (sim->getOutputEnd() != MyRunTrace::Clock::time_point())
+            tracer.span("write output", sim->getOutputStart(), sim->getOutputEnd());
+    };
+
+    result.state = CellState::Error;
+    try
+    {
+        sim.emplace(algoName, writeFiles && ctx.options->writeOutput, writeFiles && ctx.options->writeLog, config);
+
+        auto loadStart = tracer.now();
+        auto house = houseLoader.get(); // parsed by the first task on the house
+        tracer.span("load house", loadStart);
+
+        sim->setHouse(*house);
+        sim->setAlgorithm(*algorithm);
+        ran = true;
+        simStart = tracer.now();
+        sim->run();
+        traceSimulation();
+
+        collectResult(*sim, result);
+        result.state = CellState::Done;
+        return;
+    }
+    catch (const CustomError &e)
+    {
+        // errors raised after the run still leave the simulation's metrics valid
+        if (ran)
+        {
+            traceSimulation();
+            collectResult(*sim, result);
+        }
+
+        string owner;
+        if (e.owner == ErrOwnership::House)
+        {
+            owner = houseName;
+        }
+
+        else if (e.owner == ErrOwnership::Algorithm)
+        {
+            owner = algoName;
+        }
+
+        else if (e.owner == ErrOwnership::Simulator)
+        {
+            owner = "Simulator";
+        }
+
+        else
+        {
+            owner = "General";
+        }
+
+        reportError(cell, owner, e.content, ctx, tracer);
+
+        result.score = e.score;
+        return;
+    }
+
+    catch (const std::exception &e)
+    {
+        reportError(cell, algoName, e.what(), ctx, tracer);
+    }
+
+    catch (...)
+    {
+        reportError(cell, "General", "An error occured in simulator", ctx, tracer);
+    }
+    result.score = 0;
+}
+
+// running one (algorithm, house) cell, on a pool worker or inside a worker process.
+// every cell owns a distinct slot in the results, so no locking is needed
+static void runTask(const Task &task, BatchResult &cell, const RunContext &ctx, MyHouseLoader &loader,
+                    const TaskTrace &tracer = TaskTrace())
+{
+    auto start = std::chrono::steady_clock::now();
+    const string &algoName = ctx.algoNames[task.algoIndex];
+    const string &houseName = ctx.houseNames[task.houseIndex];
+    const fs::path &housePath = ctx.housePaths[task.houseIndex];
+    MyHouseLoader *houseLoader = &loader;
+    const BatchOptions &options = *ctx.options;
+
+    const ConfigValues *config = taskConfig(task, ctx);
+    identifyCell(cell, task);
+
+    // log files aren't cached, a run that writes them always simulates. a house given without its file has nothing to hash,
+    // and the key covers neither the seed nor swept parameters
+    bool useCache = options.cache != nullptr && !options.writeLog && !housePath.empty() && !task.seeded && config == nullptr;
+    fs::path outputPath = MySimulator::outputFilePath(houseName, algoName);
+    const fs::path *cachedOutput = options.writeOutput ? &outputPath : nullptr;
+    string cacheKey;
+
+    if (useCache)
+    {
+        auto lookupStart = tracer.now();
+        cacheKey = options.cache->cellKey(algoName, ctx.algoLibs[task.algoIndex], housePath);
+        bool hit = options.cache->lookup(cacheKey, cell.result, cachedOutput);
+        tracer.span("cache lookup", lookupStart);
+        if (hit)
+        {
+            houseLoader->release();
+            return;
+        }
+    }
+
+    std::unique_ptr<AbstractAlgorithm> algorithm;
+    try
+    {
+        algorithm = ctx.algoFactories[task.algoIndex]();
+        if (task.seeded)
+            dynamic_cast<SeededAlgorithm &>(*algorithm).setSeed(task.seed);
+
+        auto *configurable = dynamic_cast<ConfigurableAlgorithm *>(algorithm.get());
+        if (config != nullptr && configurable != nullptr)
+            configurable->setConfig(*config);
+    }
+    catch (const std::exception &e)
+    {
+        // an algorithm that can't be created never ran, its summary.csv entry stays empty. one that was created and
+        // rejects its seed or config fails the cell before its first step
+        if (algorithm != nullptr)
+            cell.result.state = CellState::Error;
+        reportError(cell, algoName, e.what(), ctx, tracer);
+        houseLoader->release();
+        return;
+    }
+
+    execAlgo(std::move(algorithm), *houseLoader, algoName, houseName, task.config == 0 && task.sample == 0, config, cell, ctx, tracer);
+    houseLoader->release();
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    cell.result.wallTime = elapsed.count();
+
+    // only clean runs are cached, a failing cell runs again and reports its error again
+    if (useCache && cell.result.state == CellState::Done)
+        options.cache->store(cacheKey, cell.result, cachedOutput);
+}
+
+// recording a finished task in the timing history, and its cell in the journal once all the cell's samples finished.
+// the journal rebuilds summary.csv, so a repeated cell is journaled like collectResults() reports it:
+// its first sample with the mean score of all of them
+static void recordTask(const vector<Task> &tasks, size_t taskIndex, const vector<BatchResult> &cells, const RunContext &ctx)
+{
+    const Task &task = tasks[taskIndex];
+    const CellResult &result = cells[taskIndex].result;
+    const string &algoName = ctx.algoNames[task.algoIndex];
+    const string &houseName = ctx.houseNames[task.houseIndex];
+
+    if (ctx.options->history != nullptr && result.state != CellState::NotRun)
+        ctx.options->history->record(algoName, houseName, result.wallTime);
+
+    size_t cell = ctx.taskCell[taskIndex];
+    if (ctx.options->journal == nullptr || cell == SIZE_MAX)
+        return;
+    if (ctx.samplesLeft[cell].fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    const vector<size_t> &samples = ctx.cellTasks[cell];
+    CellResult journaled;
+    vector<size_t> scores;
+    for (size_t sample : samples)
+    {
+        if (tasks[sample].sample == 0)
+            journaled = cells[sample].result;
+        scores.push_back(cells[sample].result.score);
+    }
+    if (scores.size() > 1)
+        journaled.score = static_cast<size_t>(std::llround(computeScoreStats(scores).mean));
+
+    ctx.options->journal->append(algoName, houseName, journaled);
+}
+
+// running the tasks on a pool of threads
+static void runOnThreads(const vector<Task> &tasks, vector<BatchResult> &cells, const RunContext &ctx)
+{
+    MyThreadPool pool(ctx.options->numThreads, ctx.options->memoryBudget, ctx.options->placement);
+    if (ctx.progress != nullptr)
+        ctx.progress->startReporting();
+
+    for (const auto &task : tasks)
+    {
+        size_t taskIndex = &task - tasks.data();
+        BatchResult *cell = &cells[taskIndex];
+        pool.submit([&tasks, &cells, &task, taskIndex, cell, &ctx]
+                    {
+                        if (ctx.progress != nullptr)
+                            ctx.progress->start(MyThreadPool::currentWorker(), taskIndex);
+
+                        TaskTrace tracer{ctx.trace, MyThreadPool::currentWorker(), taskIndex};
+                        auto start = tracer.now();
+                        // what runTask() doesn't handle itself (the cache, out of memory) still fails only the cell
+                        try
+                        {
+                            runTask(task, *cell, ctx, *ctx.houseLoaders[task.houseIndex], tracer);
+                        }
+                        catch (const std::exception &e)
+                        {
+                            cell->result.state = CellState::Error;
+                            cell->result.score = 0;
+                            reportError(*cell, ctx.algoNames[task.algoIndex], e.what(), ctx, tracer);
+                        }
+                        catch (...)
+                        {
+                            cell->result.state = CellState::Error;
+                            cell->result.score = 0;
+                            reportError(*cell, "General", "An error occured in simulator", ctx, tracer);
+                        }
+                        recordTask(tasks, taskIndex, cells, ctx);
+                        tracer.span(nullptr, start);
+
+                        if (ctx.progress != nullptr)
+                            ctx.progress->finish(MyThreadPool::currentWorker(), cell->result); },
+                    task.memory, task.node);
+    }
+
+    // Waiting for all tasks to finish, the workers are joined when the pool goes out of scope
+    pool.wait();
+}
+
+// running the tasks on pre-forked worker processes, so a crashing or hanging algorithm
+// only costs its own cell. a worker is killed once its task overruns timeoutCoefficient * MaxSteps
+static void runIsolated(const vector<Task> &tasks, vector<BatchResult> &cells, const RunContext &ctx)
+{
+    // the supervisor needs the simulator's timeout to know when to kill a worker
+    uint timeoutCoefficient = 0;
+    vector<pair<string, uint *>> pairs = {{"timeoutCoefficient", &timeoutCoefficient}};
+    try
+    {
+        loadConfig(SIM_CONFIG_NAME, pairs);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        // every simulation reports the missing config itself
+    }
+
+    vector<size_t> order(tasks.size());
+    for (size_t i = 0; i < tasks.size(); i++)
+        order[i] = i;
+
+    // the workers would inherit the pending errors and write them again
+    MyErrorLog::getErrorLog().flush();
+
+    // the workers and the supervisor both write the cells' errors, only appending
+    if (ctx.options->writeErrors)
+    {
+        vector<string> errorFiles = {"Simulator", "General"};
+        errorFiles.insert(errorFiles.end(), ctx.algoNames.begin(), ctx.algoNames.end());
+        errorFiles.insert(errorFiles.end(), ctx.houseNames.begin(), ctx.houseNames.end());
+        MyErrorLog::getErrorLog().claim(errorFiles);
+    }
+
+    // the workers don't report to the history or the journal, they only exist in the supervisor.
+    // a worker leaves without its destructors, it writes its errors after every task.
+    // a worker only sees its own tasks, so it can't tell when a house is done with. it parses the house of every
+    // task and drops it with the task, holding no house beyond what the task's memory estimate counts.
+    // a house given parsed is shared with the supervisor instead
+    MyProcessPool pool(ctx.options->numThreads, [&tasks, &ctx](size_t taskIndex)
+                       {
+                           const Task &task = tasks[taskIndex];
+                           BatchResult cell;
+                           if (ctx.housesParsed[task.houseIndex])
+                           {
+                               runTask(task, cell, ctx, *ctx.houseLoaders[task.houseIndex]);
+                           }
+                           else
+                           {
+                               MyHouseLoader loader(ctx.housePaths[task.houseIndex], 1);
+                               runTask(task, cell, ctx, loader);
+                           }
+                           MyErrorLog::getErrorLog().flush();
+                           return cell.result; },
+                       ctx.options->memoryBudget, ctx.options->placement);
+    if (ctx.progress != nullptr)
+    {
+        // the replacement of a lost worker is forked without the reporter thread
+        MyRunProgress *progress = ctx.progress;
+        pool.onRespawn([progress]
+                       { progress->stopReporting(); },
+                       [progress]
+                       { progress->startReporting(); });
+        progress->startReporting();
+    }
+
+    // a sweep may set the timeout of every task
+    auto budgetMs = [&tasks, &ctx, timeoutCoefficient](size_t taskIndex)
+    {
+        uint coefficient = timeoutCoefficient;
+        const ConfigValues *config = taskConfig(tasks[taskIndex], ctx);
+        if (config != nullptr && config->count("timeoutCoefficient") > 0)
+            std::istringstream(config->at("timeoutCoefficient")) >> coefficient;
+
+        return static_cast<double>(coefficient) * ctx.houseHeaders[tasks[taskIndex].houseIndex].maxSteps;
+    };
+
+    // the worker every running task was handed to and when, for the live progress and the trace.
+    // the phases of a task happen in its worker process, the trace only has the task's span
+    vector<size_t> taskWorkers(tasks.size(), 0);
+    vector<MyRunTrace::Clock::time_point> taskStarts(ctx.trace != nullptr ? tasks.size() : 0);
+    auto onStart = [&taskWorkers, &taskStarts, &ctx](size_t taskIndex, size_t worker)
+    {
+        taskWorkers[taskIndex] = worker;
+        if (ctx.trace != nullptr)
+            taskStarts[taskIndex] = MyRunTrace::Clock::now();
+        if (ctx.progress != nullptr)
+            ctx.progress->start(worker, taskIndex);
+    };
+
+    auto traceTask = [&taskWorkers, &taskStarts, &ctx](size_t taskIndex)
+    {
+        if (ctx.trace != nullptr)
+            ctx.trace->span(taskWorkers[taskIndex], taskIndex, nullptr, taskStarts[taskIndex], MyRunTrace::Clock::now());
+    };
+
+    auto onDone = [&tasks, &cells, &ctx, &taskWorkers, &traceTask](size_t taskIndex, const CellResult &result)
+    {
+        const Task &task = tasks[taskIndex];
+        identifyCell(cells[taskIndex], task);
+        cells[taskIndex].result = result;
+        recordTask(tasks, taskIndex, cells, ctx);
+        traceTask(taskIndex);
+
+        if (ctx.progress != nullptr)
+            ctx.progress->finish(taskWorkers[taskIndex], result);
+    };
+
+    // a lost cell scores like a timed out simulation. the supervisor parses a house only for its first lost cell,
+    // and keeps only the score
+    vector<std::optional<size_t>> lostScores(ctx.houseNames.size());
+    auto lostScore = [&ctx, &lostScores](size_t houseIndex)
+    {
+        std::optional<size_t> &score = lostScores[houseIndex];
+        if (score)
+            return *score;
+
+        try
+        {
+            auto house = ctx.housesParsed[houseIndex] ? ctx.houseLoaders[houseIndex]->get()
+                                                      : std::make_shared<const MyHouse>(ctx.housePaths[houseIndex]);
+            score = house->getMaxSteps() * 2 + house->getTotalDirt() * 300 + 2000;
+        }
+        catch (const CustomError &e)
+        {
+            score = 0; // the house itself is invalid
+        }
+        return *score;
+    };
+
+    auto onLost = [&tasks, &cells, &ctx, &budgetMs, &taskWorkers, &traceTask, &lostScore](size_t taskIndex, bool timedOut, int signal)
+    {
+        const Task &task = tasks[taskIndex];
+        const string &algoName = ctx.algoNames[task.algoIndex];
+        BatchResult &cell = cells[taskIndex];
+        CellResult &result = cell.result;
+
+        identifyCell(cell, task);
+        result.state = CellState::Error;
+        result.wallTime = budgetMs(taskIndex);
+        result.timedOut = timedOut;
+        result.score = lostScore(task.houseIndex);
+
+        if (timedOut)
+            reportError(cell, algoName, "Timeout reached at "s + std::to_string(static_cast<size_t>(budgetMs(taskIndex))) + "ms, worker killed", ctx);
+        else
+            reportError(cell, algoName, "Worker crashed"s + (signal != 0 ? " by signal "s + std::to_string(signal) : ""s), ctx);
+
+        recordTask(tasks, taskIndex, cells, ctx);
+        traceTask(taskIndex);
+
+        if (ctx.progress != nullptr)
+            ctx.progress->finish(taskWorkers[taskIndex], result);
+    };
+
+    auto memory = [&tasks](size_t taskIndex)
+    {
+        return tasks[taskIndex].memory;
+    };
+
+    auto node = [&tasks](size_t taskIndex)
+    {
+        return tasks[taskIndex].node;
+    };
+
+    pool.run(order, budgetMs, memory, node, onStart, onDone, onLost);
+}
+
+// ordering the tasks longest first (LPT), so a huge house doesn't start last and set the makespan.
+// a task's cost is its measured runtime from the history, or the proxy cost of its house
+// scaled to milliseconds by the runs that do have history
+static void sortTasksByCost(vector<Task> &tasks, const vector<string> &algoNames, const vector<string> &houseNames,
+                            const vector<HouseHeader> &houseHeaders, MyTimingHistory *history)
+{
+    vector<double> houseProxies;
+    for (const auto &header : houseHeaders)
+        houseProxies.push_back(proxyCost(header));
+
+    double msPerUnit = 0;
+    if (history != nullptr)
+    {
+        std::map<pair<string, string>, double> proxyCosts;
+        for (const auto &task : tasks)
+            proxyCosts[{algoNames[task.algoIndex], houseNames[task.houseIndex]}] = houseProxies[task.houseIndex];
+
+        msPerUnit = history->msPerProxyUnit(proxyCosts);
+    }
+    if (msPerUnit == 0)
+        msPerUnit = 1; // no history - the proxies are only compared to each other
+
+    for (auto &task : tasks)
+    {
+        double measured = history != nullptr ? history->lookup(algoNames[task.algoIndex], houseNames[task.houseIndex]) : -1;
+        task.cost = measured >= 0 ? measured : houseProxies[task.houseIndex] * msPerUnit;
+    }
+
+    std::stable_sort(tasks.begin(), tasks.end(), [](const Task &a, const Task &b)
+                     { return a.cost > b.cost; });
+}
+
+// giving every house a NUMA node, so the tasks sharing a house run where it was parsed.
+// the houses go to the node with the least cost so far, largest first, to keep the nodes evenly loaded
+static void assignHouseNodes(vector<Task> &tasks, size_t numHouses, const MyPlacement &placement)
+{
+    if (!placement.isPinned())
+        return;
+
+    vector<double> houseCosts(numHouses, 0);
+    for (const auto &task : tasks)
+        houseCosts[task.houseIndex] += task.cost;
+
+    vector<size_t> houses(numHouses);
+    for (size_t j = 0; j < numHouses; j++)
+        houses[j] = j;
+    std::stable_sort(houses.begin(), houses.end(), [&houseCosts](size_t a, size_t b)
+                     { return houseCosts[a] > houseCosts[b]; });
+
+    vector<double> nodeCosts(placement.numNodes(), 0);
+    vector<int> houseNodes(numHouses, -1);
+    for (size_t house : houses)
+    {
+        size_t node = std::min_element(nodeCosts.begin(), nodeCosts.end()) - nodeCosts.begin();
+        houseNodes[house] = static_cast<int>(node);
+        nodeCosts[node] += houseCosts[house];
+    }
+
+    for (auto &task : tasks)
+        task.node = houseNodes[task.houseIndex];
+}
+
+size_t MySimulatorBatch::addAlgorithm(string name, AlgorithmFactory factory, fs::path library)
+{
+    algorithms.push_back({std::move(name), std::move(factory), std::move(library)});
+    return algorithms.size() - 1;
+}
+
+void MySimulatorBatch::addAlgorithms(const AlgorithmRegistrar &registrar)
+{
+    // the factories capture the registrar entries by reference - the registrar outlives the run
+    for (const auto &algo : registrar)
+        addAlgorithm(algo.name(), [&algo]
+                     { return algo.create(); });
+}
+
+size_t MySimulatorBatch::addHouse(shared_ptr<const MyHouse> house, fs::path path)
+{
+    HouseHeader header;
+    header.maxSteps = house->getMaxSteps();
+    header.maxBattery = static_cast<size_t>(house->getMaxBattery());
+    header.rows = house->getRows() - 2; // without the padding
+    header.cols = house->getCols() - 2;
+
+    string name = house->getName();
+    houses.push_back({std::move(name), std::move(house), std::move(path), header});
+    return houses.size() - 1;
+}
+
+size_t MySimulatorBatch::addHouse(const fs::path &path)
+{
+    HouseHeader header;
+    readHouseHeader(path, header); // an unreadable house keeps an empty header, it fails when it's parsed
+
+    houses.push_back({path.stem().string(), nullptr, path, header});
+    return houses.size() - 1;
+}
+
+vector<string> MySimulatorBatch::getAlgoNames() const
+{
+    vector<string> names;
+    for (const auto &algo : algorithms)
+        names.push_back(algo.name);
+    return names;
+}
+
+vector<string> MySimulatorBatch::getHouseNames() const
+{
+    vector<string> names;
+    for (const auto &house : houses)
+        names.push_back(house.name);
+    return names;
+}
+
+vector<BatchResult> MySimulatorBatch::run()
+{
+    RunContext ctx;
+    ctx.options = &options;
+    for (const auto &algo : algorithms)
+    {
+        ctx.algoFactories.push_back(algo.factory);
+        ctx.algoNames.push_back(algo.name);
+        ctx.algoLibs.push_back(algo.library);
+    }
+    for (const auto &house : houses)
+    {
+        ctx.houseNames.push_back(house.name);
+        ctx.housePaths.push_back(house.path);
+        ctx.housesParsed.push_back(house.parsed != nullptr);
+        ctx.houseHeaders.push_back(house.header);
+    }
+
+    // the seeded algorithms are the ones that make random choices, only they are given seeds and repeated
+    bool seeding = options.seed.has_value() || options.repeats > 1;
+    uint64_t baseSeed = options.seed ? *options.seed : (static_cast<uint64_t>(std::random_device()()) << 32) | std::random_device()();
+    vector<bool> seeded(algorithms.size(), false);
+    for (size_t i = 0; i < algorithms.size() && seeding; ++i)
+    {
+        try
+        {
+            seeded[i] = dynamic_cast<SeededAlgorithm *>(algorithms[i].factory().get()) != nullptr;
+        }
+        catch (const std::exception &e)
+        {
+            // every task of the algorithm reports it
+        }
+    }
+
+    // collecting the tasks and ordering them by their estimated cost
+    vector<Task> tasks;
+    for (size_t i = 0; i < algorithms.size(); ++i)
+    {
+        size_t samples = seeded[i] ? std::max<size_t>(options.repeats, 1) : 1;
+        size_t configs = std::max<size_t>(options.configs.size(), 1);
+        for (size_t j = 0; j < houses.size(); ++j)
+        {
+            if (options.filter && !options.filter(i, j))
+                continue;
+
+            for (size_t c = 0; c < configs; ++c)
+            {
+                for (size_t r = 0; r < samples; ++r)
+                    tasks.push_back({i, j, 0, memoryFootprint(houses[j].header), -1, c, r, seeded[i], seeded[i] ? baseSeed + r : 0});
+            }
+        }
+    }
+    sortTasksByCost(tasks, ctx.algoNames, ctx.houseNames, ctx.houseHeaders, options.history);
+    assignHouseNodes(tasks, houses.size(), options.placement);
+
+    std::map<pair<size_t, size_t>, size_t> cellIndices;
+    for (size_t t = 0; t < tasks.size(); t++)
+    {
+        if (tasks[t].config != 0)
+        {
+            ctx.taskCell.push_back(SIZE_MAX);
+            continue;
+        }
+
+        auto [it, added] = cellIndices.insert({{tasks[t].algoIndex, tasks[t].houseIndex}, ctx.cellTasks.size()});
+        if (added)
+            ctx.cellTasks.emplace_back();
+        ctx.cellTasks[it->second].push_back(t);
+        ctx.taskCell.push_back(it->second);
+    }
+    ctx.samplesLeft.reset(new std::atomic<size_t>[ctx.cellTasks.size()]);
+    for (size_t c = 0; c < ctx.cellTasks.size(); c++)
+        ctx.samplesLeft[c].store(ctx.cellTasks[c].size(), std::memory_order_relaxed);
+
+    // every house is parsed once, by the first task that runs on it
+    vector<size_t> houseUses(houses.size(), 0);
+    for (const auto &task : tasks)
+        houseUses[task.houseIndex]++;
+
+    for (size_t j = 0; j < houses.size(); ++j)
+    {
+        if (houses[j].parsed)
+            ctx.houseLoaders.push_back(std::make_unique<MyHouseLoader>(houses[j].parsed, houseUses[j]));
+        else
+            ctx.houseLoaders.push_back(std::make_unique<MyHouseLoader>(houses[j].path, houseUses[j]));
+    }
+
+    vector<string> taskNames;
+    if (!options.statsPath.empty() || !options.tracePath.empty())
+    {
+        for (const auto &task : tasks)
+            taskNames.push_back(ctx.algoNames[task.algoIndex] + " " + ctx.houseNames[task.houseIndex]);
+    }
+
+    // reports until the tasks are done, and once more when it goes out of scope
+    std::optional<MyRunProgress> progress;
+    if (!options.statsPath.empty())
+        progress.emplace(options.statsPath, taskNames, options.numThreads);
+    ctx.progress = progress ? &*progress : nullptr;
+
+    // written when it goes out of scope
+    std::optional<MyRunTrace> trace;
+    if (!options.tracePath.empty())
+        trace.emplace(options.tracePath, taskNames, options.numThreads);
+    ctx.trace = trace ? &*trace : nullptr;
+
+    vector<BatchResult> cells(tasks.size());
+    if (options.isolate)
+        runIsolated(tasks, cells, ctx);
+    else
+        runOnThreads(tasks, cells, ctx);
+
+    MyErrorLog::getErrorLog().flush();
+
+    std::sort(cells.begin(), cells.end(), [](const BatchResult &a, const BatchResult &b)
+              { return std::tie(a.algoIndex, a.houseIndex, a.config, a.sample) < std::tie(b.algoIndex, b.houseIndex, b.config, b.sample); });
+
+    return cells;
+}
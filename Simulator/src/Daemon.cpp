@@ -0,0 +1,380 @@
+#include "Daemon.h"
+
+#include <csignal>
+#include <dlfcn.h>
+#include <poll.h>
+#include <set>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define CLIENT_TIMEOUT_MS 1000
+
+static volatile std::sig_atomic_t stopSignal = 0;
+
+static void onStopSignal(int)
+{
+    stopSignal = 1;
+}
+
+MyDaemon::MyDaemon(BatchOptions options, fs::path housePath, fs::path algoPath, string socketPath, string csvFileName,
+                   string historyPath, bool detailedSummary)
+    : options(std::move(options)), housePath(std::move(housePath)), algoPath(std::move(algoPath)),
+      socketPath(std::move(socketPath)), csvFileName(std::move(csvFileName)), historyPath(std::move(historyPath)),
+      detailedSummary(detailedSummary), runs(0), listenFd(-1), stopping(false)
+{
+    // every run's cells are kept by the daemon, the journal's layout can't follow the algorithms coming and going
+    this->options.journal = nullptr;
+    this->options.filter = nullptr;
+    this->options.configs.clear(); // the results hold a single run of every cell
+
+    // the socket server is a thread of its own, and MyProcessPool forks its workers from a single threaded process
+    this->options.isolate = false;
+}
+
+MyDaemon::~MyDaemon()
+{
+    stopping = true;
+    if (server.joinable())
+        server.join();
+
+    if (listenFd >= 0)
+    {
+        close(listenFd);
+        unlink(socketPath.c_str());
+    }
+
+    while (!libraries.empty())
+        unloadLibrary(libraries.begin()->first);
+}
+
+void MyDaemon::loadHouses()
+{
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(housePath, ec))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".house")
+            houseFiles.push_back(entry.path());
+    }
+
+    for (const auto &file : houseFiles)
+    {
+        houseNames.push_back(file.stem().string());
+        try
+        {
+            houses.push_back(std::make_shared<const MyHouse>(file));
+        }
+        catch (const CustomError &e)
+        {
+            houses.push_back(nullptr); // every run reports the error again
+        }
+    }
+}
+
+void MyDaemon::scanLibraries(vector<fs::path> &changed, vector<fs::path> &removed)
+{
+    auto now = fs::file_time_type::clock::now();
+    std::set<fs::path> present;
+
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(algoPath, ec))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".so")
+            continue;
+
+        fs::path path = entry.path();
+        present.insert(path);
+
+        auto mtime = entry.last_write_time(ec);
+        uintmax_t size = entry.file_size(ec);
+        if (ec)
+            continue;
+
+        auto it = libraries.find(path);
+        if (it != libraries.end() && it->second.mtime == mtime && it->second.size == size)
+            continue;
+
+        // a library that is still being written waits for the next scan
+        if (now - mtime < std::chrono::milliseconds(DAEMON_SCAN_INTERVAL_MS))
+            continue;
+
+        changed.push_back(path);
+    }
+
+    for (const auto &[path, library] : libraries)
+    {
+        if (present.count(path) == 0)
+            removed.push_back(path);
+    }
+}
+
+void MyDaemon::unloadLibrary(const fs::path &path)
+{
+    auto it = libraries.find(path);
+    if (it == libraries.end())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (const auto &algoName : it->second.algoNames)
+            results.erase(algoName);
+    }
+
+    // the factories point into the library, they go before it does
+    it->second.algoFactories.clear();
+    if (it->second.handle != nullptr)
+        dlclose(it->second.handle);
+
+    libraries.erase(it);
+}
+
+void MyDaemon::loadLibrary(const fs::path &path)
+{
+    unloadLibrary(path);
+
+    Library library;
+    std::error_code ec;
+    library.mtime = fs::last_write_time(path, ec);
+    library.size = fs::file_size(path, ec);
+
+    // the registrar only holds what this library registers while loading
+    auto &registrar = AlgorithmRegistrar::getAlgorithmRegistrar();
+    registrar.clear();
+
+    // a library may stay mapped after dlclose (unique symbols keep it loaded), and dlopen of the same path
+    // would hand back the old version without registering anything. every version is loaded from a copy of its own
+    static size_t loads = 0;
+    fs::path copy = fs::temp_directory_path(ec) / ("myrobot-" + std::to_string(getpid()) + "-" + std::to_string(loads++) + "-" +
+                                                   path.filename().string());
+    fs::copy_file(path, copy, fs::copy_options::overwrite_existing, ec);
+
+    // local, so a new version's symbols don't bind to those of an old one that stayed mapped
+    string filename = path.stem().string();
+    library.handle = ec ? nullptr : dlopen(copy.c_str(), RTLD_LOCAL | RTLD_NOW);
+    if (library.handle == nullptr)
+        writeErrFile(filename, "Error in filename: '" + filename + "' - Failed loading: " + (ec ? ec.message() : string(dlerror())));
+
+    fs::remove(copy, ec); // the mapping outlives the file
+
+    for (const auto &algo : registrar)
+    {
+        library.algoNames.push_back(algo.name());
+        library.algoFactories.push_back([algo]
+                                        { return algo.create(); });
+    }
+    registrar.clear();
+
+    // remembered even when it failed, so it's only retried once it changes
+    libraries[path] = std::move(library);
+}
+
+void MyDaemon::runLibraries(const vector<fs::path> &paths)
+{
+    MySimulatorBatch batch(options);
+
+    vector<string> algoNames;
+    for (const auto &path : paths)
+    {
+        const Library &library = libraries[path];
+        for (size_t i = 0; i < library.algoNames.size(); i++)
+        {
+            batch.addAlgorithm(library.algoNames[i], library.algoFactories[i], path);
+            algoNames.push_back(library.algoNames[i]);
+        }
+    }
+
+    if (algoNames.empty())
+        return;
+
+    for (size_t j = 0; j < houses.size(); j++)
+    {
+        if (houses[j])
+            batch.addHouse(houses[j], houseFiles[j]); // the file keys the cache
+        else
+            batch.addHouse(houseFiles[j]);
+    }
+
+    vector<BatchResult> cells = batch.run();
+
+    std::lock_guard<std::mutex> lock(mtx);
+    for (const auto &algoName : algoNames)
+        results[algoName] = vector<CellResult>(houses.size());
+    for (const auto &cell : cells)
+        results[algoNames[cell.algoIndex]][cell.houseIndex] = cell.result;
+    runs++;
+}
+
+MyResultMatrix MyDaemon::currentResults()
+{
+    vector<string> algoNames;
+    for (const auto &[algoName, row] : results)
+        algoNames.push_back(algoName);
+
+    MyResultMatrix matrix(algoNames, houseNames);
+    for (size_t i = 0; i < algoNames.size(); i++)
+    {
+        const auto &row = results[algoNames[i]];
+        for (size_t j = 0; j < row.size(); j++)
+            matrix.at(i, j) = row[j];
+    }
+
+    return matrix;
+}
+
+void MyDaemon::writeSummary()
+{
+    MyResultMatrix matrix = [this]
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return currentResults();
+    }();
+
+    if (!matrix.writeCSV(csvFileName))
+        writeErrFile("csv", "Failed to open csv file");
+
+    if (detailedSummary && !matrix.writeDetailedCSV(DETAILED_SUMMARY_FILE_NAME))
+        writeErrFile("csv", "Failed to open detailed csv file");
+}
+
+bool MyDaemon::startServer()
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+        return false;
+    std::copy(socketPath.begin(), socketPath.end(), address.sun_path);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0)
+        return false;
+
+    unlink(socketPath.c_str()); // left behind by a daemon that was killed
+    if (bind(listenFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listenFd, SOMAXCONN) != 0)
+    {
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    server = std::thread(&MyDaemon::serverLoop, this);
+    return true;
+}
+
+void MyDaemon::serverLoop()
+{
+    while (!stopping)
+    {
+        pollfd listening = {listenFd, POLLIN, 0};
+        if (poll(&listening, 1, DAEMON_SCAN_INTERVAL_MS) <= 0)
+            continue;
+
+        int clientFd = accept(listenFd, nullptr, nullptr);
+        if (clientFd < 0)
+            continue;
+
+        // a command is a single line, a client that doesn't send one in time is dropped
+        string line;
+        char c;
+        pollfd client = {clientFd, POLLIN, 0};
+        while (poll(&client, 1, CLIENT_TIMEOUT_MS) > 0 && read(clientFd, &c, 1) == 1 && c != '\n')
+            line += c;
+
+        string reply = handleCommand(line);
+        size_t written = 0;
+        while (written < reply.size())
+        {
+            ssize_t n = send(clientFd, reply.data() + written, reply.size() - written, MSG_NOSIGNAL);
+            if (n <= 0)
+                break;
+            written += static_cast<size_t>(n);
+        }
+
+        close(clientFd);
+    }
+}
+
+string MyDaemon::handleCommand(const string &line)
+{
+    std::istringstream ss(line);
+    string command;
+    ss >> command;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    if (command == "summary")
+    {
+        std::ostringstream csv;
+        currentResults().writeCSV(csv);
+        return csv.str();
+    }
+
+    if (command == "result")
+    {
+        string algoName, houseName;
+        ss >> algoName >> houseName;
+
+        auto row = results.find(algoName);
+        auto house = std::find(houseNames.begin(), houseNames.end(), houseName);
+        if (row == results.end() || house == houseNames.end())
+            return "none\n";
+
+        const CellResult &result = row->second[house - houseNames.begin()];
+        return result.state == CellState::NotRun ? "none\n" : formatCellResult(result) + "\n";
+    }
+
+    if (command == "status")
+    {
+        return "algorithms " + std::to_string(results.size()) + "\n" +
+               "houses " + std::to_string(houseNames.size()) + "\n" +
+               "runs " + std::to_string(runs) + "\n";
+    }
+
+    if (command == "quit")
+    {
+        stopping = true;
+        return "bye\n";
+    }
+
+    return "error unknown command\n";
+}
+
+int MyDaemon::run()
+{
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+
+    loadHouses();
+    if (!startServer())
+    {
+        writeErrFile("daemon", "Failed to listen on " + socketPath);
+        return EXIT_FAILURE;
+    }
+
+    while (!stopping && !stopSignal)
+    {
+        vector<fs::path> changed, removed;
+        scanLibraries(changed, removed);
+
+        for (const auto &path : removed)
+            unloadLibrary(path);
+        for (const auto &path : changed)
+            loadLibrary(path);
+
+        if (!changed.empty())
+            runLibraries(changed);
+
+        if (!changed.empty() || !removed.empty())
+        {
+            writeSummary();
+            if (options.history != nullptr)
+                options.history->save(historyPath);
+        }
+
+        MyErrorLog::getErrorLog().flush(); // the errors of libraries that failed to load
+
+        // sleeping in short slices, so a stop request isn't kept waiting for a whole interval
+        for (int slept = 0; slept < DAEMON_SCAN_INTERVAL_MS && !stopping && !stopSignal; slept += 100)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+#include "ErrorLog.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+MyErrorLog &MyErrorLog::getErrorLog()
+{
+    static MyErrorLog errorLog;
+    return errorLog;
+}
+
+MyErrorLog::~MyErrorLog()
+{
+    flush();
+}
+
+void MyErrorLog::add(const string &filename, const string &content)
+{
+    Entry *entry = new Entry{filename, content, pending.load(std::memory_order_relaxed)};
+    while (!pending.compare_exchange_weak(entry->next, entry, std::memory_order_release, std::memory_order_relaxed))
+        ;
+
+    // the worker that fills a batch writes it, unless a flush is already running
+    if (numPending.fetch_add(1, std::memory_order_relaxed) + 1 >= ERROR_FLUSH_BATCH)
+    {
+        std::unique_lock<std::mutex> lock(flushMtx, std::try_to_lock);
+        if (lock.owns_lock())
+            writePending();
+    }
+}
+
+void MyErrorLog::flush()
+{
+    std::lock_guard<std::mutex> lock(flushMtx);
+    writePending();
+}
+
+void MyErrorLog::claim(const vector<string> &filenames)
+{
+    std::lock_guard<std::mutex> lock(flushMtx);
+    for (const auto &filename : filenames)
+    {
+        if (!opened.insert(filename).second)
+            continue;
+
+        std::error_code ec;
+        fs::remove(ERROR_DIR_PATH + filename + ".error", ec);
+    }
+}
+
+void MyErrorLog::writePending()
+{
+    Entry *head = pending.exchange(nullptr, std::memory_order_acquire);
+    numPending.store(0, std::memory_order_relaxed);
+    if (head == nullptr)
+        return;
+
+    // the list is newest first
+    vector<Entry *> entries;
+    for (Entry *entry = head; entry != nullptr; entry = entry->next)
+        entries.push_back(entry);
+    std::reverse(entries.begin(), entries.end());
+
+    // a house error is reported by every algorithm that runs on it, a file holds it once
+    std::map<string, vector<string>> batch;
+    for (Entry *entry : entries)
+    {
+        const vector<string> &inFile = written[entry->filename];
+        vector<string> &toWrite = batch[entry->filename];
+        if (std::find(inFile.begin(), inFile.end(), entry->content) == inFile.end() &&
+            std::find(toWrite.begin(), toWrite.end(), entry->content) == toWrite.end())
+            toWrite.push_back(entry->content);
+        delete entry;
+    }
+
+    std::error_code ec;
+    fs::create_directories(ERROR_DIR_PATH, ec); // creates the directory if doesn't exists
+
+    for (auto &[filename, contents] : batch)
+    {
+        vector<string> &inFile = written[filename];
+        if (contents.empty())
+            continue;
+
+        bool first = opened.insert(filename).second;
+        std::ofstream file(ERROR_DIR_PATH + filename + ".error", first ? std::ios::out | std::ios::trunc : std::ios::out | std::ios::app);
+        if (!file)
+            continue;
+
+        for (const auto &content : contents)
+            file << content << "\n";
+
+        inFile.insert(inFile.end(), contents.begin(), contents.end());
+    }
+}
+
+void writeErrFile(const string &filename, const string &content)
+{
+    MyErrorLog::getErrorLog().add(filename, content);
+}
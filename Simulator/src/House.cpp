@@ -0,0 +1,182 @@
+#include "House.h"
+
+// reads the value of a "<Key> = <value>" header line
+static size_t readHeaderValue(std::istream &file)
+{
+    string line;
+    size_t value = 0;
+
+    getline(file, line, '=');
+    getline(file, line);
+    std::stringstream ss(line);
+    ss >> value;
+
+    return value;
+}
+
+bool readHouseHeader(const fs::path &housePath, HouseHeader &header)
+{
+    std::ifstream file(housePath);
+    if (!file)
+        return false;
+
+    string description;
+    getline(file, description);
+
+    header.maxSteps = readHeaderValue(file);
+    header.maxBattery = readHeaderValue(file);
+    header.rows = readHeaderValue(file);
+    header.cols = readHeaderValue(file);
+
+    return true;
+}
+
+MyHouse::MyHouse(const fs::path &filename)
+    : name(filename.stem().string()), description(""),
+      maxSteps(0), maxBattery(0), rows(0), cols(0),
+      structure(), wallMask(), dockingLocation(0, 0), totalDirt(0)
+{
+    // read input file into house structures
+    std::ifstream file(filename);
+    if (!file)
+        throw CustomError(ErrOwnership::House, "Invalid input file in readHouseFile method"s);
+
+    string line, word;
+    std::stringstream ss;
+
+    getline(file, description);
+
+    getline(file, line, '=');
+    getline(file, line);
+    ss.str(line);
+    ss >> maxSteps;
+    ss.clear();
+
+    getline(file, line, '=');
+    getline(file, line);
+    ss.str(line);
+    ss >> maxBattery;
+    ss.clear();
+
+    getline(file, line, '=');
+    getline(file, line);
+    ss.str(line);
+    ss >> rows;
+    ss.clear();
+
+    getline(file, line, '=');
+    getline(file, line);
+    ss.str(line);
+    ss >> cols;
+    ss.clear();
+
+    // read house structure from file.
+    size_t letterCode;
+    bool dockingFound = false;
+
+    structure = MyHouseGrid(rows + 2, cols + 2);
+    // +2 for house wall padding for both sides.
+    for (size_t i = 0; i < rows; i++)
+    {
+        // get current line from file and allocate memory for it
+        if (!file.eof())
+            getline(file, line);
+        else
+            line = " ";
+
+        if (line.empty())
+            line = " ";
+
+        for (size_t j = 0; j < cols; j++)
+        {
+
+            if (j < line.length())
+                letterCode = MyUtils::charToSize_t(line[j]);
+
+            else
+                letterCode = CLEAN_CODE;
+
+            if (letterCode == DOCKING_CODE)
+            {
+                if (dockingFound)
+                {
+                    // found more then 1 docking stations overall, the file is invalid
+                    throw CustomError(ErrOwnership::House, "Invalid input file, more than 1 docking station was found"s);
+                }
+                dockingFound = true;
+                dockingLocation.first = i + 1;  // +1 for wall padding
+                dockingLocation.second = j + 1; // +1 for wall padding
+            }
+
+            structure.at(i + 1, j + 1) = static_cast<uint8_t>(letterCode); // +1 for wall padding
+        }
+    }
+
+    file.close();
+
+    if (!dockingFound)
+        throw CustomError(ErrOwnership::House, "Docking station not found"s);
+
+    wallPadding();
+    wallMask = structure.wallMask();
+    sumDirt();
+}
+
+void MyHouse::wallPadding()
+{
+    rows += 2;
+    cols += 2;
+
+    for (size_t i = 0; i < rows; i++)
+    {
+        structure.at(i, 0) = WALL_CODE;
+        structure.at(i, cols - 1) = WALL_CODE;
+    }
+    for (size_t j = 0; j < cols; j++)
+    {
+        structure.at(0, j) = WALL_CODE;
+        structure.at(rows - 1, j) = WALL_CODE;
+    }
+}
+
+void MyHouse::sumDirt()
+{
+    totalDirt = 0;
+    for (uint8_t element : structure.getCells())
+    {
+        if (element <= MAX_DIRT)
+            totalDirt += element;
+    }
+}
+
+MyHouseLoader::MyHouseLoader(shared_ptr<const MyHouse> parsed, size_t uses)
+    : usesLeft(uses)
+{
+    std::call_once(once, [this, &parsed]
+                   { house = std::move(parsed); });
+}
+
+shared_ptr<const MyHouse> MyHouseLoader::get()
+{
+    std::call_once(once, [this]
+                   {
+        try
+        {
+            house = std::make_shared<const MyHouse>(path);
+        }
+        catch (const CustomError &e)
+        {
+            error = std::make_unique<CustomError>(e);
+        } });
+
+    if (error)
+        throw *error;
+
+    return house;
+}
+
+void MyHouseLoader::release()
+{
+    if (--usesLeft == 0)
+        house.reset();
+}
@@ -0,0 +1,93 @@
+#include "Journal.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <map>
+
+MyResultJournal::~MyResultJournal()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+void MyResultJournal::writeLine(const string &line)
+{
+    // a single write per record - concurrent O_APPEND writes don't interleave
+    ssize_t written = write(fd, line.data(), line.size());
+    (void)written; // a failed record only costs the crash safety of that cell
+}
+
+bool MyResultJournal::open(const string &path, const vector<string> &algoNames, const vector<string> &houseNames)
+{
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0)
+        return false;
+
+    string layout;
+    for (const auto &algoName : algoNames)
+        layout += "A " + algoName + "\n";
+    for (const auto &houseName : houseNames)
+        layout += "H " + houseName + "\n";
+
+    writeLine(layout);
+    return true;
+}
+
+void MyResultJournal::append(const string &algoName, const string &houseName, const CellResult &result)
+{
+    if (fd < 0)
+        return;
+
+    writeLine("C " + algoName + " " + houseName + " " + formatCellResult(result) + "\n");
+}
+
+MyResultMatrix MyResultJournal::rebuild(const string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+        throw std::invalid_argument("Error: Can't open journal file (" + path + ")");
+
+    vector<string> algoNames, houseNames;
+    vector<pair<pair<string, string>, CellResult>> records;
+
+    string line;
+    while (getline(file, line))
+    {
+        if (file.eof())
+            break; // the last record has no newline - the run was killed while writing it
+
+        std::istringstream ss(line);
+        string kind, algoName, houseName;
+        ss >> kind;
+
+        if (kind == "A" && ss >> algoName)
+            algoNames.push_back(algoName);
+
+        else if (kind == "H" && ss >> houseName)
+            houseNames.push_back(houseName);
+
+        else if (kind == "C")
+        {
+            CellResult result;
+            if (ss >> algoName >> houseName && parseCellResult(ss, result))
+                records.push_back({{algoName, houseName}, result});
+        }
+    }
+
+    std::map<string, size_t> algoIndex, houseIndex;
+    for (size_t i = 0; i < algoNames.size(); i++)
+        algoIndex[algoNames[i]] = i;
+    for (size_t j = 0; j < houseNames.size(); j++)
+        houseIndex[houseNames[j]] = j;
+
+    MyResultMatrix results(algoNames, houseNames);
+    for (const auto &[key, result] : records)
+    {
+        auto algoIt = algoIndex.find(key.first);
+        auto houseIt = houseIndex.find(key.second);
+        if (algoIt != algoIndex.end() && houseIt != houseIndex.end())
+            results.at(algoIt->second, houseIt->second) = result;
+    }
+
+    return results;
+}
@@ -0,0 +1,173 @@
+#include "Placement.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <pthread.h>
+#include <sched.h>
+
+// a core number, the whole text, below CPU_SETSIZE like every core a cpu_set_t can hold
+static bool parseCpu(const string &text, int &cpu)
+{
+    size_t end = 0;
+    try
+    {
+        cpu = std::stoi(text, &end);
+    }
+    catch (const std::logic_error &e)
+    {
+        return false;
+    }
+
+    return end == text.size() && cpu >= 0 && cpu < CPU_SETSIZE;
+}
+
+bool parseCpuList(const string &value, vector<int> &cpus)
+{
+    std::istringstream ss(value);
+    string range;
+
+    while (getline(ss, range, ','))
+    {
+        if (range.empty())
+            continue;
+
+        size_t dash = range.find('-');
+        int first = 0, last = 0;
+        if (!parseCpu(range.substr(0, dash), first))
+            return false;
+        if (dash == string::npos)
+            last = first;
+        else if (!parseCpu(range.substr(dash + 1), last) || last < first)
+            return false;
+
+        for (int cpu = first; cpu <= last; cpu++)
+            cpus.push_back(cpu);
+    }
+
+    return true;
+}
+
+// the cores of every node that the process may run on, a single node if the system doesn't expose them
+static std::map<int, vector<int>> readTopology()
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        return {};
+
+    std::map<int, vector<int>> nodeCpus;
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(NUMA_NODES_DIR, ec))
+    {
+        string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 || !std::isdigit(static_cast<unsigned char>(name[4])))
+            continue;
+
+        std::ifstream file(entry.path() / "cpulist");
+        string line;
+        vector<int> cpus;
+        if (!getline(file, line) || !parseCpuList(line, cpus))
+            continue;
+
+        int node = std::stoi(name.substr(4));
+        for (int cpu : cpus)
+        {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+                nodeCpus[node].push_back(cpu);
+        }
+    }
+
+    if (nodeCpus.empty())
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, &allowed))
+                nodeCpus[0].push_back(cpu);
+        }
+    }
+
+    return nodeCpus;
+}
+
+bool MyPlacement::init(PinMode mode, size_t numWorkers, const vector<int> &cpuList)
+{
+    cpus.clear();
+    nodes.clear();
+    nodeCount = 1;
+
+    if (mode == PinMode::None || numWorkers == 0)
+        return true;
+
+    std::map<int, vector<int>> nodeCpus = readTopology();
+    if (nodeCpus.empty())
+        return false;
+
+    std::map<int, int> cpuNode;
+    for (const auto &[node, nodeCores] : nodeCpus)
+    {
+        for (int cpu : nodeCores)
+            cpuNode[cpu] = node;
+    }
+
+    // the cores in the order the worker slots take them
+    vector<int> order;
+    if (mode == PinMode::Compact)
+    {
+        for (const auto &[node, nodeCores] : nodeCpus)
+            order.insert(order.end(), nodeCores.begin(), nodeCores.end());
+    }
+    else if (mode == PinMode::Scatter)
+    {
+        for (size_t k = 0; order.size() < cpuNode.size(); k++)
+        {
+            for (const auto &[node, nodeCores] : nodeCpus)
+            {
+                if (k < nodeCores.size())
+                    order.push_back(nodeCores[k]);
+            }
+        }
+    }
+    else
+    {
+        // cores outside the process's affinity are skipped
+        for (int cpu : cpuList)
+        {
+            if (cpuNode.count(cpu) > 0)
+                order.push_back(cpu);
+        }
+    }
+
+    if (order.empty())
+        return false;
+
+    // more workers than cores wrap around
+    for (size_t i = 0; i < numWorkers; i++)
+    {
+        cpus.push_back(order[i % order.size()]);
+        nodes.push_back(cpuNode[cpus.back()]);
+    }
+
+    // nodes are renumbered densely, so they can index per node tables
+    vector<int> usedNodes = nodes;
+    std::sort(usedNodes.begin(), usedNodes.end());
+    usedNodes.erase(std::unique(usedNodes.begin(), usedNodes.end()), usedNodes.end());
+    for (auto &node : nodes)
+        node = static_cast<int>(std::lower_bound(usedNodes.begin(), usedNodes.end(), node) - usedNodes.begin());
+    nodeCount = usedNodes.size();
+
+    return true;
+}
+
+void MyPlacement::pin(size_t worker) const
+{
+    if (!isPinned())
+        return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[worker % cpus.size()], &set);
+
+    // a failure leaves the worker unpinned, which only costs locality
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
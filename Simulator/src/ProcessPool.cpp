@@ -0,0 +1,319 @@
+#include "ProcessPool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <deque>
+#include <climits>
+#include <csignal>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// the result message of a worker, small enough for a pipe to deliver it in one piece
+struct ResultMessage
+{
+    uint64_t taskIndex;
+    CellResult result;
+};
+static_assert(sizeof(ResultMessage) <= PIPE_BUF, "result message must be written atomically");
+
+// reads exactly size bytes. returns false on EOF or error
+static bool readFully(int fd, void *buffer, size_t size)
+{
+    char *pos = static_cast<char *>(buffer);
+    while (size > 0)
+    {
+        ssize_t n = read(fd, pos, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+
+        pos += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static bool writeFully(int fd, const void *buffer, size_t size)
+{
+    const char *pos = static_cast<const char *>(buffer);
+    while (size > 0)
+    {
+        ssize_t n = write(fd, pos, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+
+        pos += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+MyProcessPool::MyProcessPool(size_t numWorkers, TaskRunner runner, size_t memoryBudget, const MyPlacement &placement)
+    : runner(std::move(runner)), memoryBudget(memoryBudget), placement(placement)
+{
+    // a worker that died leaves a broken pipe behind, writing to it must not kill the supervisor
+    signal(SIGPIPE, SIG_IGN);
+
+    if (numWorkers == 0)
+        numWorkers = 1;
+
+    workers.resize(numWorkers);
+    for (auto &worker : workers)
+        spawn(worker);
+}
+
+MyProcessPool::~MyProcessPool()
+{
+    // closing the task pipes lets the idle workers exit
+    for (auto &worker : workers)
+    {
+        if (worker.pid > 0)
+            reap(worker, worker.busy, nullptr);
+    }
+}
+
+void MyProcessPool::spawn(Worker &worker)
+{
+    int taskPipe[2], resultPipe[2];
+    if (pipe(taskPipe) != 0)
+        throw std::runtime_error("Failed creating a pipe for a worker process");
+    if (pipe(resultPipe) != 0)
+    {
+        close(taskPipe[0]);
+        close(taskPipe[1]);
+        throw std::runtime_error("Failed creating a pipe for a worker process");
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(taskPipe[0]);
+        close(taskPipe[1]);
+        close(resultPipe[0]);
+        close(resultPipe[1]);
+        throw std::runtime_error("Failed forking a worker process");
+    }
+
+    if (pid == 0)
+    {
+        // the worker must not hold the other workers' pipes, or they would never see EOF
+        for (auto &other : workers)
+        {
+            if (other.taskFd >= 0)
+                close(other.taskFd);
+            if (other.resultFd >= 0)
+                close(other.resultFd);
+        }
+        close(taskPipe[1]);
+        close(resultPipe[0]);
+
+        // a respawned worker keeps the core of the slot it replaces
+        placement.pin(static_cast<size_t>(&worker - workers.data()));
+
+        workerLoop(taskPipe[0], resultPipe[1]);
+    }
+
+    close(taskPipe[0]);
+    close(resultPipe[1]);
+
+    worker.pid = pid;
+    worker.taskFd = taskPipe[1];
+    worker.resultFd = resultPipe[0];
+    worker.busy = false;
+}
+
+void MyProcessPool::respawn(Worker &worker)
+{
+    if (beforeRespawn)
+        beforeRespawn();
+
+    try
+    {
+        spawn(worker);
+    }
+    catch (...)
+    {
+        if (afterRespawn)
+            afterRespawn();
+        throw;
+    }
+
+    if (afterRespawn)
+        afterRespawn();
+}
+
+void MyProcessPool::reap(Worker &worker, bool kill, int *signal)
+{
+    if (kill)
+        ::kill(worker.pid, SIGKILL);
+
+    close(worker.taskFd);
+    close(worker.resultFd);
+
+    int status = 0;
+    while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR)
+        ;
+
+    if (signal != nullptr)
+        *signal = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+
+    worker.pid = -1;
+    worker.taskFd = -1;
+    worker.resultFd = -1;
+    worker.busy = false;
+}
+
+void MyProcessPool::workerLoop(int taskFd, int resultFd)
+{
+    uint64_t taskIndex;
+    while (readFully(taskFd, &taskIndex, sizeof(taskIndex)))
+    {
+        ResultMessage message;
+        message.taskIndex = taskIndex;
+        try
+        {
+            message.result = runner(taskIndex);
+        }
+        catch (...)
+        {
+            message.result = CellResult();
+            message.result.state = CellState::Error;
+        }
+
+        if (!writeFully(resultFd, &message, sizeof(message)))
+            break;
+    }
+
+    // skipping the static destructors and atexit handlers of the supervisor's copy
+    _exit(EXIT_SUCCESS);
+}
+
+void MyProcessPool::run(const vector<size_t> &order, const function<double(size_t)> &budgetMs, const function<size_t(size_t)> &memory,
+                        const function<int(size_t)> &node, const StartHandler &onStart, const DoneHandler &onDone,
+                        const LostHandler &onLost)
+{
+    std::deque<size_t> queued(order.begin(), order.end());
+    size_t memoryInUse = 0, running = 0;
+
+    // the first queued task that fits in the memory left, one for the worker's node if there is any.
+    // a task larger than the whole budget runs alone
+    auto nextAdmitted = [&](int workerNode)
+    {
+        auto admitted = queued.end();
+        for (auto it = queued.begin(); it != queued.end(); ++it)
+        {
+            if (memoryBudget != 0 && running != 0 && memoryInUse + memory(*it) > memoryBudget)
+                continue;
+
+            int taskNode = node(*it);
+            if (workerNode < 0 || taskNode < 0 || taskNode == workerNode)
+                return it;
+
+            if (admitted == queued.end())
+                admitted = it;
+        }
+
+        return admitted;
+    };
+
+    auto finish = [&](Worker &worker)
+    {
+        worker.busy = false;
+        memoryInUse -= worker.memory;
+        running--;
+    };
+
+    while (true)
+    {
+        // handing out tasks to the idle workers
+        for (auto &worker : workers)
+        {
+            if (worker.busy)
+                continue;
+
+            auto next = nextAdmitted(placement.nodeOf(static_cast<size_t>(&worker - workers.data())));
+            if (next == queued.end())
+                continue;
+
+            uint64_t taskIndex = *next;
+            if (!writeFully(worker.taskFd, &taskIndex, sizeof(taskIndex)))
+            {
+                // the worker died while idle, replacing it keeps the task for the next round
+                reap(worker, false, nullptr);
+                respawn(worker);
+                continue;
+            }
+
+            queued.erase(next);
+            worker.busy = true;
+            worker.taskIndex = taskIndex;
+            worker.memory = memory(taskIndex);
+            memoryInUse += worker.memory;
+            running++;
+            auto budget = std::chrono::duration<double, std::milli>(budgetMs(taskIndex) + KILL_GRACE_MS);
+            worker.deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget);
+            onStart(taskIndex, static_cast<size_t>(&worker - workers.data()));
+        }
+
+        // waiting for a result or for the nearest deadline
+        vector<pollfd> fds;
+        vector<Worker *> polled;
+        auto now = std::chrono::steady_clock::now();
+        auto nearest = std::chrono::steady_clock::time_point::max();
+        for (auto &worker : workers)
+        {
+            if (!worker.busy)
+                continue;
+
+            fds.push_back({worker.resultFd, POLLIN, 0});
+            polled.push_back(&worker);
+            nearest = std::min(nearest, worker.deadline);
+        }
+
+        if (fds.empty())
+            return; // every task is done
+
+        auto waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(nearest - now).count();
+        waitMs = std::max<decltype(waitMs)>(waitMs, 0) + 1; // rounding up, so a worker isn't killed a moment early
+        if (poll(fds.data(), fds.size(), static_cast<int>(std::min<decltype(waitMs)>(waitMs, INT32_MAX))) < 0 && errno != EINTR)
+            throw std::runtime_error("Failed polling the worker processes");
+
+        now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < fds.size(); i++)
+        {
+            Worker &worker = *polled[i];
+
+            if (fds[i].revents != 0)
+            {
+                ResultMessage message;
+                if (readFully(worker.resultFd, &message, sizeof(message)))
+                {
+                    finish(worker);
+                    onDone(message.taskIndex, message.result);
+                    continue;
+                }
+
+                // EOF - the worker crashed in the middle of the task
+                size_t taskIndex = worker.taskIndex;
+                int signal = 0;
+                finish(worker);
+                reap(worker, false, &signal);
+                respawn(worker);
+                onLost(taskIndex, false, signal);
+            }
+
+            else if (now >= worker.deadline)
+            {
+                size_t taskIndex = worker.taskIndex;
+                finish(worker);
+                reap(worker, true, nullptr);
+                respawn(worker);
+                onLost(taskIndex, true, SIGKILL);
+            }
+        }
+    }
+}
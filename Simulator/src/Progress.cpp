@@ -0,0 +1,136 @@
+#include "Progress.h"
+
+#include <iomanip>
+
+MyRunProgress::MyRunProgress(string path, vector<string> taskNames, size_t numWorkers)
+    : path(std::move(path)), taskNames(std::move(taskNames)), numWorkers(numWorkers == 0 ? 1 : numWorkers),
+      slots(new WorkerSlot[this->numWorkers]), startTime(std::chrono::steady_clock::now()), stopping(false)
+{
+}
+
+void MyRunProgress::startReporting()
+{
+    if (reporter.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = false;
+    }
+    reporter = std::thread(&MyRunProgress::reporterLoop, this);
+}
+
+void MyRunProgress::stopReporting()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    stopCond.notify_all();
+    if (reporter.joinable())
+        reporter.join();
+}
+
+MyRunProgress::~MyRunProgress()
+{
+    stopReporting();
+    writeStats();
+}
+
+int64_t MyRunProgress::nowNs() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void MyRunProgress::start(size_t worker, size_t taskIndex)
+{
+    WorkerSlot &slot = slots[worker % numWorkers];
+    slot.startNs.store(nowNs(), std::memory_order_relaxed);
+    slot.task.store(taskIndex, std::memory_order_release);
+}
+
+void MyRunProgress::finish(size_t worker, const CellResult &result)
+{
+    // only this worker writes its slot, so a load and a store are enough
+    WorkerSlot &slot = slots[worker % numWorkers];
+    auto bump = [](std::atomic<size_t> &counter, size_t by)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    };
+
+    bump(slot.done, 1);
+    bump(slot.steps, result.numSteps);
+    if (result.state != CellState::Done)
+        bump(slot.errors, 1);
+    if (result.timedOut)
+        bump(slot.timeouts, 1);
+
+    slot.task.store(IDLE, std::memory_order_release);
+}
+
+void MyRunProgress::reporterLoop()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!stopCond.wait_for(lock, std::chrono::milliseconds(STATS_INTERVAL_MS), [this]
+                              { return stopping; }))
+    {
+        writeStats();
+    }
+}
+
+void MyRunProgress::writeStats()
+{
+    int64_t now = nowNs();
+    size_t done = 0, running = 0, errors = 0, timeouts = 0, steps = 0;
+    std::ostringstream workers;
+    workers << std::fixed << std::setprecision(1);
+
+    for (size_t i = 0; i < numWorkers; i++)
+    {
+        const WorkerSlot &slot = slots[i];
+        done += slot.done.load(std::memory_order_relaxed);
+        errors += slot.errors.load(std::memory_order_relaxed);
+        timeouts += slot.timeouts.load(std::memory_order_relaxed);
+        steps += slot.steps.load(std::memory_order_relaxed);
+
+        size_t task = slot.task.load(std::memory_order_acquire);
+        if (task == IDLE || task >= taskNames.size())
+        {
+            workers << "worker " << i << " idle\n";
+            continue;
+        }
+
+        running++;
+        double elapsedMs = static_cast<double>(now - slot.startNs.load(std::memory_order_relaxed)) / 1e6;
+        workers << "worker " << i << " " << taskNames[task] << " " << std::max(elapsedMs, 0.0) << "\n";
+    }
+
+    // a slot read between its counters and its task may count a task twice, for one report at most
+    size_t total = taskNames.size();
+    size_t started = std::min(done + running, total);
+    double elapsedSec = static_cast<double>(now) / 1e9;
+
+    std::ostringstream stats;
+    stats << std::fixed << std::setprecision(1)
+          << "elapsed_sec " << elapsedSec << "\n"
+          << "queued " << total - started << "\n"
+          << "running " << running << "\n"
+          << "done " << done << "\n"
+          << "total " << total << "\n"
+          << "errors " << errors << "\n"
+          << "timeouts " << timeouts << "\n"
+          << "steps " << steps << "\n"
+          << "steps_per_sec " << (elapsedSec > 0 ? static_cast<double>(steps) / elapsedSec : 0.0) << "\n"
+          << workers.str();
+
+    string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::out | std::ios::trunc);
+        if (!file)
+            return;
+        file << stats.str();
+    }
+
+    std::error_code ec;
+    fs::rename(tmpPath, path, ec); // a failed report is only skipped, the next one tries again
+}
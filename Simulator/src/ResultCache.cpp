@@ -0,0 +1,124 @@
+#include "ResultCache.h"
+#include "Hash.h"
+
+#include <algorithm>
+#include <iomanip>
+
+// hashing a file in chunks, huge houses aren't loaded whole
+static uint64_t hashFileBytes(const fs::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    uint64_t hash = FNV_OFFSET_BASIS;
+    char buffer[1 << 16];
+
+    while (file)
+    {
+        file.read(buffer, sizeof(buffer));
+        hash = fnv1a(buffer, static_cast<size_t>(file.gcount()), hash);
+    }
+
+    return hash;
+}
+
+bool MyResultCache::open(const fs::path &cacheDir)
+{
+    std::error_code ec;
+    fs::create_directories(cacheDir, ec);
+    if (ec)
+        return false;
+
+    dir = cacheDir;
+
+    // every config takes part in the key, sorted so the directory order doesn't matter
+    vector<fs::path> configs;
+    fs::path configDir = MyUtils::findConfigDir();
+    if (fs::is_directory(configDir))
+    {
+        for (const auto &entry : fs::directory_iterator(configDir))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".config")
+                configs.push_back(entry.path());
+        }
+    }
+    std::sort(configs.begin(), configs.end());
+
+    configHash = FNV_OFFSET_BASIS;
+    for (const auto &config : configs)
+    {
+        configHash = fnv1a(config.filename().string(), configHash);
+        configHash = fnv1a(std::to_string(hashFileBytes(config)), configHash);
+    }
+
+    return true;
+}
+
+uint64_t MyResultCache::fileHash(const fs::path &path)
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = fileHashes.find(path);
+        if (it != fileHashes.end())
+            return it->second;
+    }
+
+    // hashing outside the lock, two workers may hash the same file once each
+    uint64_t hash = hashFileBytes(path);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    fileHashes[path] = hash;
+    return hash;
+}
+
+string MyResultCache::cellKey(const string &algoName, const fs::path &libPath, const fs::path &housePath)
+{
+    uint64_t hash = fnv1a(algoName);
+    hash = fnv1a(std::to_string(fileHash(libPath)), hash);
+    hash = fnv1a(std::to_string(fileHash(housePath)), hash);
+    hash = fnv1a(std::to_string(configHash), hash);
+
+    std::ostringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+bool MyResultCache::lookup(const string &key, CellResult &result, const fs::path *outputPath)
+{
+    std::ifstream file(dir / key);
+    if (!file || !parseCellResult(file, result))
+        return false;
+
+    if (outputPath != nullptr)
+    {
+        // the entry is only useful if the output file can be served as well
+        std::error_code ec;
+        fs::create_directories(outputPath->parent_path(), ec);
+        fs::copy_file(dir / (key + ".txt"), *outputPath, fs::copy_options::overwrite_existing, ec);
+        if (ec)
+            return false;
+    }
+
+    return true;
+}
+
+void MyResultCache::store(const string &key, const CellResult &result, const fs::path *outputPath)
+{
+    std::error_code ec;
+
+    if (outputPath != nullptr)
+    {
+        fs::path tmpOutput = dir / (key + ".txt.tmp");
+        fs::copy_file(*outputPath, tmpOutput, fs::copy_options::overwrite_existing, ec);
+        if (!ec)
+            fs::rename(tmpOutput, dir / (key + ".txt"), ec);
+    }
+
+    // written aside and renamed, so a killed run never leaves a torn entry
+    fs::path tmpPath = dir / (key + ".tmp");
+    {
+        std::ofstream file(tmpPath, std::ios::out | std::ios::trunc);
+        if (!file)
+            return;
+        file << formatCellResult(result) << '\n';
+    }
+    fs::rename(tmpPath, dir / key, ec);
+}
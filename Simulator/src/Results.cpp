@@ -0,0 +1,137 @@
+#include "Results.h"
+
+#include <algorithm>
+#include <cmath>
+
+string formatCellResult(const CellResult &result)
+{
+    std::ostringstream ss;
+    ss << static_cast<int>(result.state) << " " << result.score << " "
+       << result.numSteps << " " << result.dirtLeft << " "
+       << static_cast<int>(result.status) << " " << result.inDock << " "
+       << result.wallTime;
+
+    return ss.str();
+}
+
+bool parseCellResult(std::istream &in, CellResult &result)
+{
+    int state, status;
+    if (!(in >> state >> result.score >> result.numSteps >> result.dirtLeft >> status >> result.inDock >> result.wallTime))
+        return false;
+
+    result.state = static_cast<CellState>(state);
+    result.status = static_cast<Status>(status);
+    return true;
+}
+
+ScoreStats computeScoreStats(vector<size_t> scores)
+{
+    ScoreStats stats;
+    stats.samples = scores.size();
+    if (scores.empty())
+        return stats;
+
+    std::sort(scores.begin(), scores.end());
+    auto percentile = [&scores](double p)
+    {
+        size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(scores.size())));
+        return scores[std::max<size_t>(rank, 1) - 1];
+    };
+
+    double sum = 0;
+    for (size_t score : scores)
+        sum += static_cast<double>(score);
+    stats.mean = sum / static_cast<double>(scores.size());
+
+    double squares = 0;
+    for (size_t score : scores)
+        squares += (static_cast<double>(score) - stats.mean) * (static_cast<double>(score) - stats.mean);
+    if (scores.size() > 1)
+        stats.stddev = std::sqrt(squares / static_cast<double>(scores.size() - 1));
+
+    stats.min = scores.front();
+    stats.p50 = percentile(0.5);
+    stats.p95 = percentile(0.95);
+    return stats;
+}
+
+MyResultMatrix::MyResultMatrix(vector<string> algoNames, vector<string> houseNames)
+    : algoNames(std::move(algoNames)), houseNames(std::move(houseNames))
+{
+    cells.resize(this->algoNames.size() * this->houseNames.size());
+}
+
+bool MyResultMatrix::isInvalidHouse(size_t houseIndex) const
+{
+    for (size_t i = 0; i < algoNames.size(); i++)
+    {
+        const auto &cell = at(i, houseIndex);
+        if (cell.state == CellState::NotRun || cell.score != 0)
+            return false;
+    }
+
+    return true;
+}
+
+bool MyResultMatrix::writeCSV(const string &filename, bool removeInvalidHouses) const
+{
+    std::ofstream file(filename); // open the file
+    if (!file.is_open())
+        return false;
+
+    writeCSV(file, removeInvalidHouses);
+
+    file.close();
+    return true;
+}
+
+void MyResultMatrix::writeCSV(std::ostream &file, bool removeInvalidHouses) const
+{
+    vector<size_t> validHouses;
+    for (size_t j = 0; j < houseNames.size(); j++)
+    {
+        if (!removeInvalidHouses || !isInvalidHouse(j))
+            validHouses.push_back(j);
+    }
+
+    file << "Algorithms";
+    for (size_t j : validHouses)
+        file << "," << houseNames[j];
+    file << "\n";
+
+    for (size_t i = 0; i < algoNames.size(); i++)
+    {
+        file << algoNames[i];
+        for (size_t j : validHouses)
+            file << "," << at(i, j).scoreStr();
+        file << "\n";
+    }
+}
+
+bool MyResultMatrix::writeDetailedCSV(const string &filename) const
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+        return false;
+
+    file << "Algorithm,House,Score,NumSteps,DirtLeft,Status,InDock,WallTimeMs,Error\n";
+
+    for (size_t i = 0; i < algoNames.size(); i++)
+    {
+        for (size_t j = 0; j < houseNames.size(); j++)
+        {
+            const auto &cell = at(i, j);
+            if (cell.state == CellState::NotRun)
+                continue;
+
+            file << algoNames[i] << "," << houseNames[j] << ","
+                 << cell.score << "," << cell.numSteps << "," << cell.dirtLeft << ","
+                 << MyUtils::statusToStr(cell.status) << "," << (cell.inDock ? "TRUE" : "FALSE") << ","
+                 << cell.wallTime << "," << (cell.state == CellState::Error ? "TRUE" : "FALSE") << "\n";
+        }
+    }
+
+    file.close();
+    return true;
+}
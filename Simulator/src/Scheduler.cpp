@@ -0,0 +1,73 @@
+#include "Scheduler.h"
+
+void MyTimingHistory::load(const string &path)
+{
+    std::ifstream file(path);
+    if (!file)
+        return; // no history yet
+
+    string line, algoName, houseName;
+    double millis;
+    while (getline(file, line))
+    {
+        std::istringstream ss(line);
+        if (ss >> algoName >> houseName >> millis)
+            runtimes[{algoName, houseName}] = millis;
+    }
+}
+
+void MyTimingHistory::save(const string &path)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file)
+        return;
+
+    for (const auto &[key, millis] : runtimes)
+        file << key.first << " " << key.second << " " << millis << '\n';
+}
+
+double MyTimingHistory::lookup(const string &algoName, const string &houseName)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    auto it = runtimes.find({algoName, houseName});
+    if (it == runtimes.end())
+        return -1;
+
+    return it->second;
+}
+
+void MyTimingHistory::record(const string &algoName, const string &houseName, double millis)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    auto it = runtimes.find({algoName, houseName});
+    if (it == runtimes.end())
+        runtimes[{algoName, houseName}] = millis;
+    else
+        it->second = (it->second + millis) / 2; // smoothing out noisy runs
+}
+
+double MyTimingHistory::msPerProxyUnit(const std::map<pair<string, string>, double> &proxyCosts)
+{
+    std::lock_guard<std::mutex> lock(mtx);
+
+    double totalMillis = 0;
+    double totalProxy = 0;
+    for (const auto &[key, proxy] : proxyCosts)
+    {
+        auto it = runtimes.find(key);
+        if (it == runtimes.end())
+            continue;
+
+        totalMillis += it->second;
+        totalProxy += proxy;
+    }
+
+    if (totalProxy == 0)
+        return 0;
+
+    return totalMillis / totalProxy;
+}
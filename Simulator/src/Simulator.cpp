@@ -1,27 +1,24 @@
 #include "Simulator.h"
 
-MySimulator::MySimulator(string algoName, bool writeOutput, bool writeLog)
+MySimulator::MySimulator(string algoName, bool writeOutput, bool writeLog, const ConfigValues *config)
     : houseDescription(""), rows(0), cols(0),
-      houseStructure({}), dockingLocation({}), currLocation({}),
+      houseStructure(), wallMask(nullptr), dockingLocation(0, 0), currLocation(0, 0),
       initDirt(0), dirtLeft(0), maxSteps(0),
       maxBattery(0), curBattery(0),
-      pAlgo(nullptr), algoName(algoName), algoScore(0), 
+      pAlgo(nullptr), pSnapshotAlgo(nullptr), pPlanningAlgo(nullptr), planPos(0), algoName(algoName), algoScore(0), 
       writeOutput(writeOutput), writeLog(writeLog),
       batteryMeter(MyBatteryMeter(curBattery)),
       dirtSensor(MyDirtSensor(houseStructure, currLocation)),
-      wallsSensor(MyWallsSensor(houseStructure, currLocation)),
+      wallsSensor(MyWallsSensor(currLocation)),
       logFile(""), currLog(LogCode::NoLog), prevLog(LogCode::NoLog),
-      numSteps(0), steps({}), status(Status::Working), 
+      numSteps(0), steps(), status(Status::Working), 
       timeoutCoefficient(0), timer(io), timeoutOccoured(false)
 {
-    dockingLocation.resize(2);
-    currLocation.resize(2);
-    
     vector<pair<string, uint*>> pairs = 
         {{"timeoutCoefficient", &timeoutCoefficient}};
 
     try{
-        loadConfig(SIM_CONFIG_NAME, pairs);
+        loadConfig(SIM_CONFIG_NAME, pairs, config);
     }
     catch(const std::invalid_argument &e)
     {
@@ -41,6 +38,12 @@ void MySimulator::setAlgorithm(AbstractAlgorithm &algo)
     algo.setDirtSensor(dirtSensor);
     algo.setBatteryMeter(batteryMeter);
     pAlgo = &algo;
+    pSnapshotAlgo = dynamic_cast<SnapshotAlgorithm *>(&algo);
+    pPlanningAlgo = dynamic_cast<PlanningAlgorithm *>(&algo);
+    plan = StepPlan();
+    planPos = 0;
+    if (pPlanningAlgo != nullptr)
+        pPlanningAlgo->setPlan(plan);
 }
 
 void MySimulator::activateTimer()
@@ -59,27 +62,49 @@ void MySimulator::run()
 {
     activateTimer();
 
+    // a step allocates nothing and throws nothing, a fault ends the loop
     Step nextStep = Step::Stay;
-    try
+    std::optional<FaultCode> fault;
+    do
     {
-        do
+        if(inWall())
         {
-            if(inWall())
-                throw FaultCode::FROBOT_IN_WALL;
+            fault = FaultCode::FROBOT_IN_WALL;
+            break;
+        }
+
+        // a planned step doesn't call the algorithm, which hears how much of the plan was taken when it ends
+        std::optional<Step> plannedStep = nextPlannedStep();
+        if (plannedStep)
+        {
+            nextStep = *plannedStep;
+            planPos++;
+        }
+        else
+        {
+            if (!plan.steps.empty())
+            {
+                pPlanningAlgo->planEnded(planPos);
+                plan.steps.clear();
+                planPos = 0;
+            }
 
-            nextStep = pAlgo->nextStep();
+            nextStep = pSnapshotAlgo != nullptr ? pSnapshotAlgo->nextStep(takeSnapshot()) : pAlgo->nextStep();
+        }
 
-            handleStep(nextStep);
+        fault = handleStep(nextStep);
+        if (fault)
+            break;
 
-            updateLogFile(nextStep);
+        updateLogFile(nextStep);
 
-            io.poll();
+        io.poll();
 
-        } while (nextStep != Step::Finish && !timeoutOccoured);
-    }
-    catch (const FaultCode &e)
+    } while (nextStep != Step::Finish && !timeoutOccoured);
+
+    if (fault)
     {
-        handleFault(e);
+        handleFault(*fault);
         updateLogFile(nextStep);
     }
 
@@ -89,7 +114,11 @@ void MySimulator::run()
 void MySimulator::finalize()
 {
     calcScore();
+    if (writeOutput)
+        outputStart = std::chrono::steady_clock::now();
     writeOutputFile();
+    if (writeOutput)
+        outputEnd = std::chrono::steady_clock::now();
     handleErrors();
     timer.cancel();
 }
@@ -109,27 +138,27 @@ void MySimulator::handleErrors()
 
 bool MySimulator::inWall()
 {
-    if(currLocation[0] < houseStructure.size() && currLocation[1] < houseStructure[0].size() &&
-        houseStructure[currLocation[0]][currLocation[1]] != WALL_CODE)
+    if(wallMask->contains(currLocation.first, currLocation.second) &&
+        (wallMask->at(currLocation.first, currLocation.second) & WALL_MASK_SELF) == 0)
         return false;
     
     return true;
 }
 
-void MySimulator::handleStep(Step step)
+std::optional<FaultCode> MySimulator::handleStep(Step step)
 {
     if (numSteps == maxSteps)
     {
-        steps.push_back(Step::Finish);
-        throw FaultCode::FOUT_OF_STEPS;
+        steps.push(Step::Finish);
+        return FaultCode::FOUT_OF_STEPS;
     }
 
-    steps.push_back(step);
+    steps.push(step);
 
     if (step == Step::Finish)
     {
         status = Status::Finished;
-        return;
+        return std::nullopt;
     }
 
     numSteps++;
@@ -140,12 +169,14 @@ void MySimulator::handleStep(Step step)
         tryChargeRobot();
     }
 
-    vector<size_t> prevLocation = currLocation;
+    pair<size_t, size_t> prevLocation = currLocation;
     currLocation = calcNewLocation(step, currLocation);
 
     // if we stayed at the docking station -> we are chraging -> no need to reduce battery
-    if (!(prevLocation == dockingLocation && prevLocation == currLocation))
-        reduceBattery();
+    if (!(prevLocation == dockingLocation && prevLocation == currLocation) && !reduceBattery())
+        return FaultCode::FBATTERY_EXHAUSTED;
+
+    return std::nullopt;
 }
 
 void MySimulator::handleFault(const FaultCode e)
@@ -158,109 +189,30 @@ void MySimulator::handleFault(const FaultCode e)
 }   
 
 
-void MySimulator::updateHouseName(const char* inputName)
+void MySimulator::setHouse(const MyHouse &house)
 {
-    string str = inputName;
-    size_t pos = str.find_last_of('/');
-
-    if (pos != string::npos)
-        houseName = str.substr(pos + 1);
-
-    houseName = houseName.substr(0, houseName.size() - 6); // remove '.house'
-}
-
-void MySimulator::readHouseFile(const char *filename)
-{
-    updateHouseName(filename);
-
-    // read input file into house structures
-    std::ifstream file(filename);
-    if (!file)
-        throw CustomError(ErrOwnership::House, "Invalid input file in readHouseFile method"s);
-    
-
-    string line, word;
-    std::stringstream ss;
-
-    getline(file, houseDescription);
-
-    getline(file, line, '=');
-    getline(file, line);
-    ss.str(line);
-    ss >> maxSteps;
-    ss.clear();
-
-    getline(file, line, '=');
-    getline(file, line);
-    ss.str(line);
-    ss >> maxBattery;
+    houseName = house.getName();
+    houseDescription = house.getDescription();
+    maxSteps = house.getMaxSteps();
+    maxBattery = house.getMaxBattery();
     curBattery = maxBattery;
-    ss.clear();
-
-    getline(file, line, '=');
-    getline(file, line);
-    ss.str(line);
-    ss >> rows;
-    ss.clear();
-
-    getline(file, line, '=');
-    getline(file, line);
-    ss.str(line);
-    ss >> cols;
-    ss.clear();
-
-    // read house structure from file.
-    size_t letterCode;
-    bool dockingFound = false;
-
-    houseStructure.resize(rows + 2, vector<size_t>(cols + 2));
-    // +2 for house wall padding for both sides.
-    for (size_t i = 0; i < rows; i++)
-    {
-        // get current line from file and allocate memory for it
-        if (!file.eof())
-            getline(file, line);
-        else
-            line = " ";
-
-        if (line.empty())
-            line = " ";
-
-        for (size_t j = 0; j < cols; j++)
-        {
+    rows = house.getRows();
+    cols = house.getCols();
 
-            if (j < line.length())
-                letterCode = charToSize_t(line[j]);
+    // the parsed house is shared between simulations, only this copy is cleaned. its walls are read in place
+    houseStructure = house.getStructure();
+    wallMask = &house.getWallMask();
+    wallsSensor.setWallMask(*wallMask);
 
-            else
-                letterCode = CLEAN_CODE;
+    dockingLocation = house.getDockingLocation();
+    currLocation = dockingLocation;
 
-            if (letterCode == DOCKING_CODE)
-            {
-                if (dockingFound)
-                {
-                    // found more then 1 docking stations overall, the file is invalid
-                    throw CustomError(ErrOwnership::House, "Invalid input file, more than 1 docking station was found"s);
-                }
-                dockingFound = true;
-                dockingLocation[0] = i + 1; // +1 for wall padding
-                dockingLocation[1] = j + 1; // +1 for wall padding
-            }
+    // a step is recorded per step taken, and a last Finish
+    steps.reset(maxSteps + 1);
 
-            houseStructure[i + 1][j + 1] = letterCode; // +1 for wall padding
-        }
-    }
-
-    file.close();
-
-    if (!dockingFound)
-        throw CustomError(ErrOwnership::House, "Docking station not found"s);
-
-    currLocation[0] = dockingLocation[0];
-    currLocation[1] = dockingLocation[1];
+    initDirt = house.getTotalDirt();
+    dirtLeft = initDirt;
 
-    houseWallPadding();
-    updateTotalDirt();
     initLogFile();
 }
 
@@ -280,23 +232,6 @@ void MySimulator::initLogFile() noexcept(false)
             << endl;
 }
 
-void MySimulator::houseWallPadding()
-{
-    rows += 2;
-    cols += 2;
-
-    for (size_t i = 0; i < rows; i++)
-    {
-        houseStructure[i][0] = WALL_CODE;
-        houseStructure[i][cols - 1] = WALL_CODE;
-    }
-    for (size_t j = 0; j < cols; j++)
-    {
-        houseStructure[0][j] = WALL_CODE;
-        houseStructure[rows - 1][j] = WALL_CODE;
-    }
-}
-
 void MySimulator::writeOutputFile()
 {
     if(!writeOutput)
@@ -306,7 +241,7 @@ void MySimulator::writeOutputFile()
 
     fs::create_directories(OUTPUT_DIR_PATH); // creates the directory if doesn't exists
 
-    const string path = OUTPUT_DIR_PATH + houseName + "-" + algoName + ".txt";
+    const string path = outputFilePath(houseName, algoName);
 
     file.open(path.c_str());
     if (!file)
@@ -315,28 +250,13 @@ void MySimulator::writeOutputFile()
     file << "NumSteps = " << numSteps << '\n';
     file << "DirtLeft = " << dirtLeft << '\n';
 
-    string outputStatus;
-    switch (status)
-    {
-    case Status::Finished:
-        outputStatus = "FINISHED";
-        break;
-    case Status::Dead:
-        outputStatus = "DEAD";
-        break;
-    case Status::Working:
-        outputStatus = "WORKING";
-        break;
-    }
-
-    file << "Status = " << outputStatus << '\n';
+    file << "Status = " << statusToStr(status) << '\n';
     string inDockStr = robotAtDocking() ? "TRUE" : "FALSE";
     file << "InDock = " << inDockStr << '\n';
     file << "Score = " << algoScore << '\n';
 
     file << "Steps" << '\n';
-    for (size_t i = 0; i < steps.size(); i++)
-        file << stepToStr(steps[i]);
+    steps.writeLabels(file);
 
     file << endl;
     file.close();
@@ -354,12 +274,7 @@ LogCode MySimulator::fetchLogCode(Step currStep)
     if (currStep == Step::Finish)
         return LogCode::Finished;
 
-    bool isStuck = true;
-    for (size_t dir = 0; dir < 4; dir++)
-    {
-        vector<size_t> neighbor = calcNewLocation(static_cast<Direction>(dir), currLocation);
-        isStuck &= (houseStructure[neighbor[0]][neighbor[1]] == WALL_CODE);
-    }
+    bool isStuck = (wallMask->at(currLocation.first, currLocation.second) & WALL_MASK_NEIGHBORS) == WALL_MASK_NEIGHBORS;
 
     if (isStuck)
         return LogCode::Stuck;
@@ -384,7 +299,8 @@ void MySimulator::updateLogFile(Step currStep)
     if (currLog == LogCode::NoLog)
         return;
 
-    vector<LogCode> nonRepetetives =
+    // charging and being stuck are only logged when they start
+    static constexpr LogCode nonRepetetives[] =
         {LogCode::Charging,
          LogCode::Stuck};
 
@@ -395,7 +311,6 @@ void MySimulator::updateLogFile(Step currStep)
     }
 
     logFile << "[" << numSteps << "] ";
-    string stepStr;
 
     switch (currLog)
     {
@@ -403,11 +318,10 @@ void MySimulator::updateLogFile(Step currStep)
         logFile << "Mission accomplished!\nThe robot at the docking station and the house is clean";
         break;
     case LogCode::Cleaning:
-        logFile << "Cleaned at location (" << currLocation[0] << "," << currLocation[1] << ")";
+        logFile << "Cleaned at location (" << currLocation.first << "," << currLocation.second << ")";
         break;
     case LogCode::Exploring:
-        stepStr = stepToFullStr(currStep);
-        logFile << "Exploring towards " << stepStr;
+        logFile << "Exploring towards " << stepFullLabels[static_cast<size_t>(currStep)];
         break;
     case LogCode::Charging:
         logFile << "Arrived to docking station, starts charging";
@@ -436,34 +350,20 @@ void MySimulator::tryChargeRobot()
 
 void MySimulator::tryToClean()
 {
-    size_t curLocationDirt = houseStructure[currLocation[0]][currLocation[1]];
+    uint8_t &curLocationDirt = houseStructure.at(currLocation.first, currLocation.second);
     if (curLocationDirt > 0 && curLocationDirt <= MAX_DIRT)
     {
         // Clean one dirt at a step
-        houseStructure[currLocation[0]][currLocation[1]]--;
+        curLocationDirt--;
         dirtLeft--;
     }
 }
 
 // Checking if it's not a wall or the docking station
-bool MySimulator::isValidLocation(vector<size_t> location) const
+bool MySimulator::isValidLocation(pair<size_t, size_t> location) const
 {
-    return location[0] < rows && location[1] < cols &&
-           houseStructure[location[0]][location[1]] <= MAX_DIRT;
-}
-
-void MySimulator::updateTotalDirt()
-{
-    initDirt = 0;
-    for (auto vec : houseStructure)
-    {
-        for (size_t element : vec)
-        {
-            if (element <= MAX_DIRT)
-                initDirt += element;
-        }
-    }
-    dirtLeft = initDirt;
+    return location.first < rows && location.second < cols &&
+           houseStructure.at(location.first, location.second) <= MAX_DIRT;
 }
 
 void MySimulator::calcScore()
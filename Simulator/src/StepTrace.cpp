@@ -0,0 +1,197 @@
+#include "StepTrace.h"
+#include "Utils.h"
+
+#include <algorithm>
+
+#define STEP_TRACE_RUN 6
+#define STEP_TRACE_MORE 4 // the third bit of a repeats symbol
+
+// the symbols needed for the number of repeats of a run
+static size_t repeatSymbols(size_t repeats)
+{
+    size_t symbols = 1;
+    while (repeats >>= 2)
+        symbols++;
+    return symbols;
+}
+
+MyStepTrace::MyStepTrace()
+    : spillFile(nullptr), spilledBytes(0), spillFailed(false), bits(0), numBits(0), numSymbols(0),
+      runStep(Step::Stay), runLength(0)
+{
+}
+
+MyStepTrace::~MyStepTrace()
+{
+    if (spillFile != nullptr)
+        std::fclose(spillFile);
+}
+
+void MyStepTrace::reset(size_t maxSteps)
+{
+    if (spillFile != nullptr)
+        std::fclose(spillFile);
+    spillFile = nullptr;
+    spilledBytes = 0;
+    spillFailed = false;
+
+    bytes.clear();
+    bytes.reserve(memoryBound(maxSteps));
+    bits = 0;
+    numBits = 0;
+    numSymbols = 0;
+    runLength = 0;
+}
+
+void MyStepTrace::writeSymbol(uint8_t symbol)
+{
+    bits |= static_cast<uint32_t>(symbol) << numBits;
+    numBits += 3;
+    numSymbols++;
+
+    if (numBits < 8)
+        return;
+
+    bytes.push_back(static_cast<uint8_t>(bits));
+    bits >>= 8;
+    numBits -= 8;
+
+    if (bytes.size() >= STEP_TRACE_SPILL_BYTES && !spillFailed)
+        spill();
+}
+
+void MyStepTrace::writeRun()
+{
+    if (runLength == 0)
+        return;
+
+    uint8_t step = static_cast<uint8_t>(runStep);
+    writeSymbol(step);
+
+    size_t repeats = runLength - 1;
+    if (repeats <= 1 + repeatSymbols(repeats))
+    {
+        for (size_t i = 0; i < repeats; i++)
+            writeSymbol(step);
+    }
+    else
+    {
+        writeSymbol(STEP_TRACE_RUN);
+        for (; repeats > 3; repeats >>= 2)
+            writeSymbol(STEP_TRACE_MORE | (repeats & 3));
+        writeSymbol(static_cast<uint8_t>(repeats));
+    }
+
+    runLength = 0;
+}
+
+void MyStepTrace::spill()
+{
+    if (spillFile == nullptr)
+        spillFile = std::tmpfile();
+
+    // a failed write is taken back, its steps and the ones after it stay in memory
+    if (spillFile == nullptr || std::fwrite(bytes.data(), 1, bytes.size(), spillFile) != bytes.size())
+    {
+        if (spillFile != nullptr)
+            std::fseek(spillFile, static_cast<long>(spilledBytes), SEEK_SET);
+        spillFailed = true;
+        return;
+    }
+
+    spilledBytes += bytes.size();
+    bytes.clear();
+}
+
+void MyStepTrace::writeLabels(std::ostream &out)
+{
+    writeRun();
+    if (numBits > 0)
+    {
+        bytes.push_back(static_cast<uint8_t>(bits));
+        bits = 0;
+        numBits = 0;
+    }
+
+    char labels[STEP_TRACE_RUN];
+    for (int i = 0; i < STEP_TRACE_RUN; i++)
+        labels[i] = MyUtils::stepToStr(static_cast<Step>(i))[0];
+
+    vector<char> text;
+    text.reserve(STEP_TRACE_READ_CHUNK);
+    auto writeLabel = [&](uint8_t step)
+    {
+        text.push_back(labels[step]);
+        if (text.size() == STEP_TRACE_READ_CHUNK)
+        {
+            out.write(text.data(), text.size());
+            text.clear();
+        }
+    };
+
+    // decoding state, kept between the chunks
+    size_t symbolsLeft = numSymbols;
+    uint32_t pending = 0;
+    unsigned pendingBits = 0;
+    uint8_t prevStep = 0;
+    bool inRepeats = false;
+    size_t repeats = 0;
+    unsigned shift = 0;
+
+    auto decode = [&](const uint8_t *data, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            pending |= static_cast<uint32_t>(data[i]) << pendingBits;
+            pendingBits += 8;
+
+            for (; pendingBits >= 3 && symbolsLeft > 0; symbolsLeft--)
+            {
+                uint8_t symbol = pending & 7;
+                pending >>= 3;
+                pendingBits -= 3;
+
+                if (inRepeats)
+                {
+                    repeats |= static_cast<size_t>(symbol & 3) << shift;
+                    shift += 2;
+                    if ((symbol & STEP_TRACE_MORE) == 0)
+                    {
+                        for (size_t r = 0; r < repeats; r++)
+                            writeLabel(prevStep);
+                        inRepeats = false;
+                    }
+                }
+                else if (symbol == STEP_TRACE_RUN)
+                {
+                    inRepeats = true;
+                    repeats = 0;
+                    shift = 0;
+                }
+                else
+                {
+                    writeLabel(symbol);
+                    prevStep = symbol;
+                }
+            }
+        }
+    };
+
+    if (spillFile != nullptr && spilledBytes > 0)
+    {
+        vector<uint8_t> chunk(STEP_TRACE_READ_CHUNK);
+        std::fflush(spillFile);
+        std::fseek(spillFile, 0, SEEK_SET);
+        for (size_t left = spilledBytes; left > 0;)
+        {
+            size_t read = std::fread(chunk.data(), 1, std::min<size_t>(left, chunk.size()), spillFile);
+            if (read == 0)
+                break;
+            decode(chunk.data(), read);
+            left -= read;
+        }
+    }
+
+    decode(bytes.data(), bytes.size());
+    out.write(text.data(), text.size());
+}
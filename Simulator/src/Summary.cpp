@@ -0,0 +1,138 @@
+#include "Summary.h"
+
+// splits a csv line, fields don't contain commas
+static vector<string> splitCSVLine(const string &line)
+{
+    vector<string> fields;
+    std::stringstream ss(line);
+    string field;
+
+    while (getline(ss, field, ','))
+        fields.push_back(field);
+
+    // a trailing comma is an empty last field
+    if (!line.empty() && line.back() == ',')
+        fields.push_back("");
+
+    return fields;
+}
+
+size_t MySummaryTable::algoIndex(const string &algoName)
+{
+    for (size_t i = 0; i < algoNames.size(); i++)
+    {
+        if (algoNames[i] == algoName)
+            return i;
+    }
+
+    algoNames.push_back(algoName);
+    cells.push_back(vector<string>(houseNames.size(), ""));
+    return algoNames.size() - 1;
+}
+
+size_t MySummaryTable::houseIndex(const string &houseName)
+{
+    for (size_t j = 0; j < houseNames.size(); j++)
+    {
+        if (houseNames[j] == houseName)
+            return j;
+    }
+
+    houseNames.push_back(houseName);
+    for (auto &row : cells)
+        row.push_back("");
+    return houseNames.size() - 1;
+}
+
+void MySummaryTable::load(const string &filename)
+{
+    std::ifstream file(filename);
+    if (!file)
+        throw std::invalid_argument("Error: Can't open summary file (" + filename + ")");
+
+    string line;
+    if (!getline(file, line))
+        return; // empty summary
+
+    vector<size_t> columns; // the table column of every house in the file
+    auto headlines = splitCSVLine(line);
+    for (size_t j = 1; j < headlines.size(); j++)
+        columns.push_back(houseIndex(headlines[j]));
+
+    while (getline(file, line))
+    {
+        if (line.empty())
+            continue;
+
+        auto fields = splitCSVLine(line);
+        size_t row = algoIndex(fields[0]);
+
+        for (size_t j = 1; j < fields.size() && j - 1 < columns.size(); j++)
+            cells[row][columns[j - 1]] = fields[j];
+    }
+}
+
+void MySummaryTable::merge(const MySummaryTable &other)
+{
+    // registering the houses first, so new houses keep their order
+    vector<size_t> columns;
+    for (const auto &houseName : other.houseNames)
+        columns.push_back(houseIndex(houseName));
+
+    for (size_t i = 0; i < other.algoNames.size(); i++)
+    {
+        size_t row = algoIndex(other.algoNames[i]);
+        for (size_t j = 0; j < other.houseNames.size(); j++)
+        {
+            if (!other.cells[i][j].empty())
+                cells[row][columns[j]] = other.cells[i][j];
+        }
+    }
+}
+
+void MySummaryTable::removeInvalidHouses()
+{
+    // Iterate over each column (from last to first to avoid issues with removing)
+    for (size_t col = houseNames.size(); col > 0; col--)
+    {
+        bool isInvalid = true;
+        for (const auto &row : cells)
+        {
+            if (row[col - 1] != "0")
+            {
+                isInvalid = false;
+                break;
+            }
+        }
+
+        if (isInvalid)
+        {
+            houseNames.erase(houseNames.begin() + (col - 1));
+            for (auto &row : cells)
+                row.erase(row.begin() + (col - 1));
+        }
+    }
+}
+
+bool MySummaryTable::write(const string &filename) const
+{
+    std::ofstream file(filename);
+    if (!file.is_open())
+        return false;
+
+    file << "Algorithms";
+    for (const auto &houseName : houseNames)
+        file << "," << houseName;
+    file << "\n";
+
+    for (size_t i = 0; i < algoNames.size(); i++)
+    {
+        file << algoNames[i];
+        for (const auto &cell : cells[i])
+            file << "," << cell;
+        file << "\n";
+    }
+
+    file.close();
+    return true;
+}
@@ -0,0 +1,116 @@
+#include "ThreadPool.h"
+
+thread_local size_t MyThreadPool::workerIndex = 0;
+
+MyThreadPool::MyThreadPool(size_t numThreads, size_t memoryBudget, const MyPlacement &placement)
+    : pending(0), memoryBudget(memoryBudget), memoryInUse(0), running(0), stopping(false), placement(placement)
+{
+    if (numThreads == 0)
+        numThreads = 1;
+
+    workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++)
+        workers.emplace_back(&MyThreadPool::workerLoop, this, i);
+}
+
+MyThreadPool::~MyThreadPool()
+{
+    {
+        std::lock_guard<mutex> lock(mtx);
+        stopping = true;
+    }
+    taskCond.notify_all();
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void MyThreadPool::submit(function<void()> task, size_t memory, int node)
+{
+    {
+        std::lock_guard<mutex> lock(mtx);
+        tasks.push_back({std::move(task), memory, node});
+        pending++;
+    }
+
+    // any worker may take it, but the ones of its node should get the chance to
+    if (placement.isPinned())
+        taskCond.notify_all();
+    else
+        taskCond.notify_one();
+}
+
+void MyThreadPool::wait()
+{
+    std::unique_lock<mutex> lock(mtx);
+    doneCond.wait(lock, [this]
+                  { return pending == 0; });
+}
+
+deque<MyThreadPool::Task>::iterator MyThreadPool::nextAdmitted(int node)
+{
+    auto admitted = tasks.end();
+    for (auto it = tasks.begin(); it != tasks.end(); ++it)
+    {
+        // a task larger than the whole budget still runs, alone
+        if (memoryBudget != 0 && running != 0 && memoryInUse + it->memory > memoryBudget)
+            continue;
+
+        if (node < 0 || it->node < 0 || it->node == node)
+            return it;
+
+        // another node's task is only taken if none of this node's fits
+        if (admitted == tasks.end())
+            admitted = it;
+    }
+
+    return admitted;
+}
+
+void MyThreadPool::workerLoop(size_t index)
+{
+    workerIndex = index;
+    placement.pin(index);
+    int node = placement.nodeOf(index);
+
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock<mutex> lock(mtx);
+            taskCond.wait(lock, [this, node]
+                          { return (stopping && tasks.empty()) || nextAdmitted(node) != tasks.end(); });
+
+            // draining the queue before stopping, so no submitted task is lost
+            if (tasks.empty())
+                return;
+
+            auto it = nextAdmitted(node);
+            task = std::move(*it);
+            tasks.erase(it);
+            memoryInUse += task.memory;
+            running++;
+        }
+
+        // a task reports its own errors, one that escapes is dropped. the bookkeeping below must always run,
+        // or wait() would never return
+        try
+        {
+            task.run();
+        }
+        catch (...)
+        {
+        }
+
+        std::lock_guard<mutex> lock(mtx);
+        memoryInUse -= task.memory;
+        running--;
+
+        // the freed memory may admit a task another worker passed over
+        if (memoryBudget != 0)
+            taskCond.notify_all();
+
+        if (--pending == 0)
+            doneCond.notify_all();
+    }
+}
@@ -0,0 +1,105 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#define TRACE_EVENTS_RESERVE 1024
+
+// the string as a JSON string literal
+static string jsonString(const string &value)
+{
+    std::ostringstream ss;
+    ss << '"';
+    for (char c : value)
+    {
+        if (c == '"' || c == '\\')
+            ss << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+            ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        else
+            ss << c;
+    }
+    ss << '"';
+    return ss.str();
+}
+
+MyRunTrace::MyRunTrace(string path, vector<string> taskNames, size_t numWorkers)
+    : path(std::move(path)), taskNames(std::move(taskNames)), numWorkers(numWorkers == 0 ? 1 : numWorkers),
+      buffers(new WorkerBuffer[this->numWorkers]), startTime(Clock::now())
+{
+    for (size_t i = 0; i < this->numWorkers; i++)
+        buffers[i].events.reserve(TRACE_EVENTS_RESERVE);
+}
+
+MyRunTrace::~MyRunTrace()
+{
+    writeTrace();
+}
+
+double MyRunTrace::toUs(Clock::time_point time) const
+{
+    return std::chrono::duration<double, std::micro>(time - startTime).count();
+}
+
+void MyRunTrace::span(size_t worker, size_t taskIndex, const char *name, Clock::time_point start, Clock::time_point end)
+{
+    buffers[worker % numWorkers].events.push_back({name, taskIndex, start, end});
+}
+
+void MyRunTrace::writeTrace() const
+{
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file)
+        return;
+
+    file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"myrobot\"}}";
+
+    // +1 when a task starts, -1 when it ends
+    vector<std::pair<Clock::time_point, int>> changes;
+
+    for (size_t worker = 0; worker < numWorkers; worker++)
+    {
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << worker
+             << ",\"args\":{\"name\":\"worker " << worker << "\"}}";
+
+        for (const auto &event : buffers[worker].events)
+        {
+            const string &taskName = event.taskIndex < taskNames.size() ? taskNames[event.taskIndex] : "";
+            file << ",\n{\"name\":" << jsonString(event.name != nullptr ? event.name : taskName)
+                 << ",\"cat\":\"" << (event.name != nullptr ? "phase" : "task") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << worker
+                 << ",\"ts\":" << toUs(event.start) << ",\"dur\":" << toUs(event.end) - toUs(event.start)
+                 << ",\"args\":{\"task\":" << jsonString(taskName) << "}}";
+
+            if (event.name == nullptr)
+            {
+                changes.push_back({event.start, 1});
+                changes.push_back({event.end, -1});
+            }
+        }
+    }
+
+    // a task that ends when another starts frees its worker first
+    std::sort(changes.begin(), changes.end());
+    size_t running = 0, started = 0;
+    file << ",\n{\"name\":\"tasks\",\"ph\":\"C\",\"pid\":1,\"ts\":0,\"args\":{\"queued\":" << taskNames.size() << ",\"running\":0}}";
+    for (const auto &[time, change] : changes)
+    {
+        if (change > 0)
+        {
+            running++;
+            started++;
+        }
+        else
+        {
+            running--;
+        }
+
+        file << ",\n{\"name\":\"tasks\",\"ph\":\"C\",\"pid\":1,\"ts\":" << toUs(time)
+             << ",\"args\":{\"queued\":" << taskNames.size() - std::min(started, taskNames.size()) << ",\"running\":" << running << "}}";
+    }
+
+    file << "\n]}\n";
+}
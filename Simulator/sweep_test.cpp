@@ -0,0 +1,142 @@
+#include "Batch.h"
+
+#include "configurable_algorithm.h"
+
+#include <mutex>
+#include <unistd.h>
+
+#define FLAG_CONFIG_NAME "sweep_test.config"
+
+// the value every run was given and the flag it read
+static std::mutex flagsMutex;
+static vector<pair<string, bool>> flagsSeen;
+
+// takes a bool parameter like AlgoB's spiralClockwise, and finishes at once
+class FlagAlgorithm : public AbstractAlgorithm, public ConfigurableAlgorithm
+{
+    bool flag = false;
+
+public:
+    virtual void setMaxSteps(size_t) override {}
+    virtual void setWallsSensor(const WallsSensor &) override {}
+    virtual void setDirtSensor(const DirtSensor &) override {}
+    virtual void setBatteryMeter(const BatteryMeter &) override {}
+    virtual Step nextStep() override { return Step::Finish; }
+
+    virtual void setConfig(const std::map<string, string> &values) override
+    {
+        vector<pair<string, bool *>> pairs = {{"flag", &flag}};
+        MyUtils::loadConfig(FLAG_CONFIG_NAME, pairs, &values);
+
+        std::lock_guard<std::mutex> lock(flagsMutex);
+        flagsSeen.push_back({values.at("flag"), flag});
+    }
+    virtual vector<string> configNames() const override { return {"flag"}; }
+};
+
+// a config file with the line "flag <value>", read from a configs directory under the CWD
+static bool readFlagFile(const string &value, bool &flag)
+{
+    fs::create_directories("configs");
+    std::ofstream(fs::path("configs") / FLAG_CONFIG_NAME) << "flag " << value << '\n';
+
+    vector<pair<string, bool *>> pairs = {{"flag", &flag}};
+    try
+    {
+        MyUtils::loadConfig(FLAG_CONFIG_NAME, pairs);
+    }
+    catch (const std::invalid_argument &e)
+    {
+        return false;
+    }
+    return true;
+}
+
+// checks that a bool parameter reads true/false and 1/0, from a sweep and from a config file, and nothing else
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <house file>" << std::endl;
+        return 2;
+    }
+
+    bool failed = false;
+
+    // a sweep of "flag true false", every cell runs with its value
+    for (const auto &values : vector<pair<string, string>>{{"true", "false"}, {"1", "0"}})
+    {
+        BatchOptions options;
+        options.numThreads = 2;
+        options.configs = {{{"flag", values.first}, {"timeoutCoefficient", "1000"}},
+                           {{"flag", values.second}, {"timeoutCoefficient", "1000"}}};
+
+        MySimulatorBatch batch(std::move(options));
+        batch.addAlgorithm("FlagAlgorithm", []
+                           { return std::make_unique<FlagAlgorithm>(); });
+        batch.addHouse(fs::path(argv[1]));
+
+        flagsSeen.clear();
+        for (const BatchResult &cell : batch.run())
+        {
+            if (cell.result.state != CellState::Done)
+            {
+                std::cerr << "sweep " << values.first << " " << values.second << ": config " << cell.config
+                          << " failed: " << cell.error << std::endl;
+                failed = true;
+            }
+        }
+
+        if (flagsSeen.size() != 2)
+            failed = true;
+        for (const auto &[value, flag] : flagsSeen)
+        {
+            if (flag != (value == values.first))
+            {
+                std::cerr << "sweep: flag " << value << " read as " << flag << std::endl;
+                failed = true;
+            }
+        }
+    }
+
+    // the same values in a config file, in a directory of its own
+    fs::path dir = fs::temp_directory_path() / ("sweep_test_" + std::to_string(getpid()));
+    fs::create_directories(dir);
+    fs::path cwd = fs::current_path();
+    fs::current_path(dir);
+
+    for (const auto &[value, expected] : vector<pair<string, bool>>{{"true", true}, {"1", true}, {"false", false}, {"0", false}})
+    {
+        bool flag = !expected;
+        if (!readFlagFile(value, flag) || flag != expected)
+        {
+            std::cerr << "config file: flag " << value << " read as " << flag << std::endl;
+            failed = true;
+        }
+    }
+
+    bool flag = false;
+    if (readFlagFile("yes", flag))
+    {
+        std::cerr << "config file: flag yes was accepted" << std::endl;
+        failed = true;
+    }
+
+    fs::current_path(cwd);
+    fs::remove_all(dir);
+
+    // a bad swept value is rejected like a bad value in the file
+    vector<pair<string, bool *>> pairs = {{"flag", &flag}};
+    MyUtils::ConfigValues bad = {{"flag", "yes"}};
+    try
+    {
+        MyUtils::loadConfig(FLAG_CONFIG_NAME, pairs, &bad);
+        std::cerr << "sweep: flag yes was accepted" << std::endl;
+        failed = true;
+    }
+    catch (const std::invalid_argument &e)
+    {
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+#include "StepTrace.h"
+#include "Utils.h"
+
+#include <algorithm>
+#include <random>
+
+#define SPILLED_STEPS 12000000 // no two equal in a row, past STEP_TRACE_SPILL_BYTES at 3 bits a step
+#define RUNS 200
+#define MAX_RUN_LENGTH 100000
+
+// records steps into the trace and into their labels
+struct Recorder
+{
+    MyStepTrace &trace;
+    string labels;
+
+    void push(Step step, size_t times = 1)
+    {
+        for (size_t i = 0; i < times; i++)
+            trace.push(step);
+        labels.append(times, MyUtils::stepToStr(step)[0]);
+    }
+
+    bool check(const char *name)
+    {
+        std::ostringstream out;
+        trace.writeLabels(out);
+        if (out.str() == labels)
+            return true;
+
+        std::cerr << name << ": " << labels.size() << " steps recorded, " << out.str().size() << " written back, ";
+        auto diff = std::mismatch(labels.begin(), labels.end(), out.str().begin(), out.str().end());
+        std::cerr << "first difference at step " << diff.first - labels.begin() << std::endl;
+        return false;
+    }
+};
+
+// checks that a trace writes back the steps it recorded: single steps, runs of every length, past the spill
+// threshold, and again after a reset
+int main()
+{
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> stepDist(0, 4);
+    std::uniform_int_distribution<size_t> lengthDist(1, MAX_RUN_LENGTH);
+    bool failed = false;
+
+    MyStepTrace trace;
+    Recorder recorder{trace, ""};
+
+    // a step never repeats, so nothing collapses and the trace spills to its file
+    trace.reset(SPILLED_STEPS + RUNS * MAX_RUN_LENGTH + 1);
+    Step prev = Step::Finish;
+    for (size_t i = 0; i < SPILLED_STEPS; i++)
+    {
+        Step step = static_cast<Step>(stepDist(gen));
+        if (step == prev)
+            step = static_cast<Step>((static_cast<int>(step) + 1) % 5);
+        recorder.push(step);
+        prev = step;
+    }
+
+    // runs of every length around the symbols a run takes, then long ones
+    for (size_t length = 1; length <= 70; length++)
+        recorder.push(static_cast<Step>(length % 5), length);
+    for (size_t i = 0; i < RUNS; i++)
+        recorder.push(static_cast<Step>(stepDist(gen)), lengthDist(gen));
+    recorder.push(Step::Finish);
+
+    failed |= !recorder.check("spilled");
+
+    // a reused trace forgets the steps before its reset
+    trace.reset(100);
+    recorder.labels.clear();
+    recorder.push(Step::Stay, 20);
+    recorder.push(Step::North, 3);
+    recorder.push(Step::Finish);
+    failed |= !recorder.check("reset");
+
+    return failed ? 1 : 0;
+}
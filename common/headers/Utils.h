@@ -1,11 +1,13 @@
 #pragma once
 
 #include "enums.h"
+#include "planning_algorithm.h"
 #include <string>
 #include <vector>
 #include <stdexcept>
 #include <memory>
 #include <filesystem>
+#include <map>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -29,6 +31,7 @@ using namespace std::string_literals;
 #define DOCKING_CODE 10
 #define WALL_CODE 11
 #define UNDISCOVERED_CODE 12
+#define CHARGE_PLAN_STEPS 20 // a charge from empty to full takes 20 steps
 
 enum class LogCode
 {
@@ -55,12 +58,13 @@ namespace MyUtils
     const string stepFullLabels[6] = {"north", "east", "south", "west", "stay", "finish"};
     const string stepLabels[6] = {"N", "E", "S", "W", "s", "F"};
     const string boolLabels[2] = {"true", "false"};
+    const string statusLabels[3] = {"WORKING", "FINISHED", "DEAD"};
     
     Step strToStep(const string &);
 
     char charToSize_t(const char);
-    vector<size_t> calcNewLocation(Direction dir, vector<size_t> curLocation);
-    vector<size_t> calcNewLocation(Step step, vector<size_t> curLocation);
+    pair<size_t, size_t> calcNewLocation(Direction dir, pair<size_t, size_t> curLocation);
+    pair<size_t, size_t> calcNewLocation(Step step, pair<size_t, size_t> curLocation);
 
     pair<int, int> calcNewPosition(Direction dir, pair<int, int> curPosition);
     pair<int, int> calcNewPosition(Step step, pair<int, int> curPosition);
@@ -68,8 +72,22 @@ namespace MyUtils
     char size_tToChar(size_t code) noexcept(false);
     Step calcStep(pair<int, int> from, pair<int, int> to);
 
+    fs::path findConfigDir();
+
+    // parameter name -> value, as it would read in a config file
+    using ConfigValues = std::map<string, string>;
+
+    // the parameters found in overrides are taken from there, the config file is only read for the rest
     template <typename T>
-    void loadConfig(const char* configName, vector<pair<string, T*>> &pairs);
+    void loadConfig(const char* configName, vector<pair<string, T*>> &pairs, const ConfigValues *overrides = nullptr);
+
+    // charging in the dock takes the same Stay until the battery is full
+    inline void planCharging(StepPlan &plan, size_t maxBattery)
+    {
+        plan.steps.assign(CHARGE_PLAN_STEPS, Step::Stay);
+        plan.stopOnDirt = false;
+        plan.stopAtBattery = maxBattery;
+    }
 
     inline string stepToStr(Step step)
     {
@@ -81,6 +99,11 @@ namespace MyUtils
         return stepFullLabels[static_cast<size_t>(step)];
     }
 
+    inline string statusToStr(Status status)
+    {
+        return statusLabels[static_cast<int>(status)];
+    }
+
     inline string directionToStr(Direction dir)
     {
         return stepLabels[static_cast<int>(dir)];
@@ -0,0 +1,19 @@
+#ifndef CONFIGURABLE_ALGORITHM_H_
+#define CONFIGURABLE_ALGORITHM_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Implemented, next to AbstractAlgorithm, by the algorithms that read a config file.
+// The simulator may set parameter values before the first step, they win over the config file.
+// Values are given the way they read in a config file, parameters the algorithm doesn't know are ignored.
+// configNames() lists the parameters it knows, a swept parameter that no algorithm knows is reported.
+class ConfigurableAlgorithm {
+public:
+	virtual ~ConfigurableAlgorithm() {}
+	virtual void setConfig(const std::map<std::string, std::string> &values) = 0;
+	virtual std::vector<std::string> configNames() const = 0;
+};
+
+#endif  // CONFIGURABLE_ALGORITHM_H_
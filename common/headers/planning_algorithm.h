@@ -0,0 +1,28 @@
+#ifndef PLANNING_ALGORITHM_H_
+#define PLANNING_ALGORITHM_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "enums.h"
+
+// Steps for the simulator to take on its own, after the step nextStep() returned.
+// Before every planned step the simulator checks the stop conditions, the plan ends at the first one that holds.
+struct StepPlan {
+	std::vector<Step> steps;
+	bool stopOnDirt = false;		// stop when the robot stands on dirt
+	std::size_t stopAtBattery = 0;	// stop when the battery, as BatteryMeter::getBatteryState(), reaches it. 0 never stops
+};
+
+// Implemented, next to AbstractAlgorithm, by the algorithms that can plan several steps ahead.
+// The simulator gives the algorithm a plan once, the algorithm fills its steps during nextStep() when the steps ahead
+// don't depend on what the robot senses on the way. The simulator takes them without calling the algorithm, and calls
+// planEnded() with the number of planned steps it took before the next nextStep(). The sensors still follow every step.
+class PlanningAlgorithm {
+public:
+	virtual ~PlanningAlgorithm() {}
+	virtual void setPlan(StepPlan &plan) = 0;
+	virtual void planEnded(std::size_t executed) = 0;
+};
+
+#endif  // PLANNING_ALGORITHM_H_
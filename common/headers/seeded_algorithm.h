@@ -0,0 +1,14 @@
+#ifndef SEEDED_ALGORITHM_H_
+#define SEEDED_ALGORITHM_H_
+
+#include <cstdint>
+
+// Implemented, next to AbstractAlgorithm, by the algorithms that make random choices.
+// The simulator sets the seed before the first step, so any single run can be reproduced.
+class SeededAlgorithm {
+public:
+	virtual ~SeededAlgorithm() {}
+	virtual void setSeed(std::uint64_t seed) = 0;
+};
+
+#endif  // SEEDED_ALGORITHM_H_
@@ -0,0 +1,27 @@
+#ifndef SNAPSHOT_ALGORITHM_H_
+#define SNAPSHOT_ALGORITHM_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "enums.h"
+
+// The sensors' readings at the robot's location, taken by the simulator once before a step.
+struct SensorSnapshot {
+	std::uint8_t walls;	  // bit d is set if there is a wall in Direction d
+	int dirtLevel;		  // as DirtSensor::dirtLevel()
+	std::size_t battery;  // as BatteryMeter::getBatteryState()
+
+	bool isWall(Direction d) const { return (walls >> static_cast<int>(d)) & 1; }
+};
+
+// Implemented, next to AbstractAlgorithm, by the algorithms that can read their sensors from a snapshot.
+// The simulator then calls nextStep(snapshot) instead of nextStep(), a single call per step instead of
+// a virtual call per sensor reading. The sensors are still set, and stay valid.
+class SnapshotAlgorithm {
+public:
+	virtual ~SnapshotAlgorithm() {}
+	virtual Step nextStep(const SensorSnapshot &snapshot) = 0;
+};
+
+#endif  // SNAPSHOT_ALGORITHM_H_
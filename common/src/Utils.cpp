@@ -32,28 +32,28 @@ char MyUtils::charToSize_t(const char c)
 }
 
 // pre: location + step is a valid location in house structure
-vector<size_t> MyUtils::calcNewLocation(Direction dir, vector<size_t> curLocation)
+pair<size_t, size_t> MyUtils::calcNewLocation(Direction dir, pair<size_t, size_t> curLocation)
 {
     // location = (rows, cols) = (y, x)
     switch (dir)
     {
     case Direction::North:
-        curLocation[0]--;
+        curLocation.first--;
         break;
     case Direction::East:
-        curLocation[1]++;
+        curLocation.second++;
         break;
     case Direction::South:
-        curLocation[0]++;
+        curLocation.first++;
         break;
     case Direction::West:
-        curLocation[1]--;
+        curLocation.second--;
         break;
     }
     return curLocation;
 }
 
-vector<size_t> MyUtils::calcNewLocation(Step step, vector<size_t> curLocation)
+pair<size_t, size_t> MyUtils::calcNewLocation(Step step, pair<size_t, size_t> curLocation)
 {
     if(step == Step::Stay || step == Step::Finish)
         return curLocation;
@@ -120,21 +120,68 @@ Step MyUtils::calcStep(pair<int,int> from, pair<int,int> to)
     return Step::Stay;
 }
 
-template <typename T>
-void MyUtils::loadConfig(const char* configName, vector<pair<string, T*>> &pairs)
+// searching the "configs" directory from the CWD upwards
+fs::path MyUtils::findConfigDir()
 {
-
-    // path finding for "configs" directory
-    fs::path startPath = fs::current_path();
-    fs::path currentPath = startPath;
+    fs::path currentPath = fs::current_path();
     while (!currentPath.empty()) {
         if (fs::exists(currentPath / "configs/")) {
             break;
         }
+        if (currentPath == currentPath.root_path()) {
+            break; // the parent of the root is the root itself
+        }
         currentPath = currentPath.parent_path();
     }
 
-    fs::path configPath = currentPath / "configs" / configName;
+    return currentPath / "configs";
+}
+
+// reads a parameter's value, the whole of it. a bool is true/false or 1/0
+template <typename T>
+static bool readConfigValue(std::istream &in, T &value)
+{
+    return static_cast<bool>(in >> value);
+}
+
+template <>
+bool readConfigValue<bool>(std::istream &in, bool &value)
+{
+    string word;
+    if (!(in >> word))
+        return false;
+
+    if (word == "true" || word == "1")
+        value = true;
+    else if (word == "false" || word == "0")
+        value = false;
+    else
+        return false;
+    return true;
+}
+
+template <typename T>
+void MyUtils::loadConfig(const char* configName, vector<pair<string, T*>> &pairs, const ConfigValues *overrides)
+{
+    vector<pair<string, T*>> fromFile;
+    for (auto &currPair : pairs)
+    {
+        auto it = overrides != nullptr ? overrides->find(currPair.first) : ConfigValues::const_iterator();
+        if (overrides == nullptr || it == overrides->end())
+        {
+            fromFile.push_back(currPair);
+            continue;
+        }
+
+        std::istringstream ss(it->second);
+        if (!readConfigValue(ss, *(currPair.second)))
+            throw std::invalid_argument("Error: Invalid value for " + currPair.first + " (" + it->second + ")");
+    }
+
+    if (fromFile.empty())
+        return; // everything was given, the file isn't needed
+
+    fs::path configPath = findConfigDir() / configName;
 
     
     std::ifstream file(configPath.string().c_str());
@@ -149,11 +196,12 @@ void MyUtils::loadConfig(const char* configName, vector<pair<string, T*>> &pairs
     {
         std::istringstream ss(line);
         ss >> param;
-        for(auto& currPair: pairs)
+        for(auto& currPair: fromFile)
         {
             if (param == currPair.first)
             {
-                ss >> *(currPair.second);
+                if (!readConfigValue(ss, *(currPair.second)))
+                    throw std::invalid_argument("Error: Invalid value for " + currPair.first + " in config file (" + configPath.string() + ")");
 
                 argsFound++;
                 break;
@@ -161,12 +209,12 @@ void MyUtils::loadConfig(const char* configName, vector<pair<string, T*>> &pairs
         }
     }
 
-    if(argsFound != pairs.size())
+    if(argsFound != fromFile.size())
     {
         string msg = "Error: Found fewer argument in config file than required. (" + configPath.string() + ")";
         throw std::invalid_argument(msg);
     }
 }
 
-template void MyUtils::loadConfig<bool>(const char*, vector<pair<string,  bool*>>&);
-template void MyUtils::loadConfig<uint>(const char*, vector<pair<string,  uint*>>&);
+template void MyUtils::loadConfig<bool>(const char*, vector<pair<string,  bool*>>&, const ConfigValues*);
+template void MyUtils::loadConfig<uint>(const char*, vector<pair<string,  uint*>>&, const ConfigValues*);